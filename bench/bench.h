@@ -0,0 +1,29 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Benchmark helpers
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* monotonic wall clock in seconds */
+static inline double bench_now(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + 1e-9 * (double)ts.tv_nsec;
+};
+
+/* keep the optimizer from discarding a result */
+static volatile double bench_sink;
+
+#endif
@@ -0,0 +1,386 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Benchmarks of every .Call entry point, called directly from C
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+#   usage: ./bench_calls [out.csv] [min n] [max n] [seconds] [entry substring] [cases.R]
+#          (defaults bench-C.csv, 1e3, 1e7, 0.2, all entries, cases.R)
+#
+#   R is embedded only to build each case's arguments from cases.R (shared with
+#   bench.R); the entry points themselves are linked in from ../src and timed as
+#   plain function calls, so the numbers exclude .Call dispatch. Each (entry, size)
+#   runs in a forked child and its peak resident set is the child's ru_maxrss,
+#   which includes the R session it inherits.
+#
+-------------------------------------------------------------------------------- */
+
+#define _DEFAULT_SOURCE
+
+#include "bench.h"
+
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include <Rembedded.h>
+#include <R.h>
+#include <Rinternals.h>
+#include <R_ext/Parse.h>
+#include <R_ext/Rdynload.h>
+
+#include "des-1.h"
+#include "des-2.h"
+#include "des-3.h"
+#include "des-4.h"
+#include "des-5.h"
+#include "des-8.h"
+#include "des-errata.h"
+
+
+/* --------------------------------------------------------------------------------
+#   the entry points (every useDynLib in NAMESPACE)
+-------------------------------------------------------------------------------- */
+
+#define CALLDEF(name, n) {#name, (DL_FUNC)&name, n}
+
+static const R_CallMethodDef calls[] = {
+  CALLDEF(des_1_2_1_C, 2),
+  CALLDEF(des_1_2_1_batch_C, 4),
+  CALLDEF(des_ssq_general_C, 6),
+  CALLDEF(des_ssq1_C, 1),
+  CALLDEF(des_ssq1_file_C, 3),
+  CALLDEF(des_1_3_1_C, 4),
+  CALLDEF(des_1_3_1_changes_C, 3),
+  CALLDEF(des_1_3_1_stream_C, 6),
+  CALLDEF(des_sis1_C, 3),
+  CALLDEF(des_sis1_batch_C, 4),
+  CALLDEF(des_2_1_1_C, 2),
+  CALLDEF(des_2_1_2_C, 2),
+  CALLDEF(des_2_2_1_C, 3),
+  CALLDEF(des_2_2_1_64_C, 3),
+  CALLDEF(des_2_2_2_C, 2),
+  CALLDEF(des_2_1_1_factor_C, 2),
+  CALLDEF(des_2_1_2_factor_C, 2),
+  CALLDEF(des_2_2_2_factor_C, 2),
+  CALLDEF(des_2_1_1_64_C, 2),
+  CALLDEF(des_2_5_1_C, 3),
+  CALLDEF(des_2_5_2_C, 3),
+  CALLDEF(des_2_5_hash_C, 3),
+  CALLDEF(des_2_5_brent_C, 3),
+  CALLDEF(des_2_5_dp_C, 5),
+  CALLDEF(des_2_5_3_C, 3),
+  CALLDEF(make_lrng_C, 2),
+  CALLDEF(random_lrng_C, 1),
+  CALLDEF(random_n_lrng_C, 3),
+  CALLDEF(skip_lrng_C, 2),
+  CALLDEF(des_ssq2_C, 5),
+  CALLDEF(des_sis2_C, 7),
+  CALLDEF(des_sis_grid_C, 9),
+  CALLDEF(make_rngs_C, 1),
+  CALLDEF(plant_seeds_rngs_C, 2),
+  CALLDEF(select_stream_rngs_C, 2),
+  CALLDEF(get_seed_rngs_C, 1),
+  CALLDEF(put_seed_rngs_C, 2),
+  CALLDEF(skip_rngs_C, 2),
+  CALLDEF(random_rngs_C, 1),
+  CALLDEF(random_n_rngs_C, 4),
+  CALLDEF(uniform_rngs_C, 5),
+  CALLDEF(equilikely_rngs_C, 5),
+  CALLDEF(exponential_rngs_C, 4),
+  CALLDEF(des_4_1_1_C, 2),
+  CALLDEF(make_welford_C, 0),
+  CALLDEF(update_welford_C, 3),
+  CALLDEF(merge_welford_C, 2),
+  CALLDEF(query_welford_C, 1),
+  CALLDEF(des_4_2_1_C, 3),
+  CALLDEF(make_hist_C, 3),
+  CALLDEF(update_hist_C, 3),
+  CALLDEF(merge_hist_C, 2),
+  CALLDEF(query_hist_C, 1),
+  CALLDEF(des_ssq3_C, 5),
+  CALLDEF(des_msq_C, 6),
+  CALLDEF(des_msq_trace_C, 5),
+  CALLDEF(evlist_hold_C, 4),
+  CALLDEF(des_8_1_1_C, 3),
+  CALLDEF(des_replicate_C, 5),
+  CALLDEF(make_outstat_C, 2),
+  CALLDEF(update_outstat_C, 2),
+  CALLDEF(query_outstat_C, 2),
+  CALLDEF(make_tavg_C, 2),
+  CALLDEF(update_tavg_C, 3),
+  CALLDEF(query_tavg_C, 2),
+  CALLDEF(gcd_C, 2),
+  CALLDEF(sieve_C, 4),
+  CALLDEF(approx_factor_C, 2),
+  CALLDEF(approx_factor_64_C, 2),
+  {NULL, NULL, 0}
+};
+
+#define BENCH_MAXARGS 9
+
+static const R_CallMethodDef* bench_lookup(const char* entry){
+  for(const R_CallMethodDef* def = calls; def->name != NULL; def++){
+    if(strcmp(def->name, entry) == 0){
+      return def;
+    }
+  }
+  return NULL;
+};
+
+/* call an entry point with its arguments in a[] */
+static SEXP bench_invoke(const R_CallMethodDef* def, SEXP* a){
+  switch(def->numArgs){
+    case 0: return ((SEXP (*)(void))def->fun)();
+    case 1: return ((SEXP (*)(SEXP))def->fun)(a[0]);
+    case 2: return ((SEXP (*)(SEXP, SEXP))def->fun)(a[0], a[1]);
+    case 3: return ((SEXP (*)(SEXP, SEXP, SEXP))def->fun)(a[0], a[1], a[2]);
+    case 4: return ((SEXP (*)(SEXP, SEXP, SEXP, SEXP))def->fun)(a[0], a[1], a[2], a[3]);
+    case 5: return ((SEXP (*)(SEXP, SEXP, SEXP, SEXP, SEXP))def->fun)(a[0], a[1], a[2], a[3], a[4]);
+    case 6: return ((SEXP (*)(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP))def->fun)(a[0], a[1], a[2], a[3], a[4], a[5]);
+    case 7: return ((SEXP (*)(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP))def->fun)(a[0], a[1], a[2], a[3], a[4], a[5], a[6]);
+    case 8: return ((SEXP (*)(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP))def->fun)(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+    case 9: return ((SEXP (*)(SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP, SEXP))def->fun)(a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8]);
+    default: Rf_error("bench_calls: %s takes too many arguments", def->name);
+  }
+  return R_NilValue;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   the embedded R session
+-------------------------------------------------------------------------------- */
+
+/* evaluate R code in the global environment; 0 if parsing or evaluation failed */
+static int bench_eval_string(const char* code){
+  ParseStatus status;
+  SEXP expr = PROTECT(R_ParseVector(Rf_mkString(code), -1, &status, R_NilValue));
+  if(status != PARSE_OK){
+    UNPROTECT(1);
+    return 0;
+  }
+  int err = 0;
+  for(R_xlen_t i = 0; i < XLENGTH(expr) && !err; i++){
+    R_tryEval(VECTOR_ELT(expr, i), R_GlobalEnv, &err);
+  }
+  UNPROTECT(1);
+  return !err;
+};
+
+/* f(x) in the global environment, or NULL on error */
+static SEXP bench_apply(SEXP f, SEXP x){
+  int err = 0;
+  SEXP call = PROTECT(Rf_lang2(f, x));
+  SEXP out = R_tryEval(call, R_GlobalEnv, &err);
+  UNPROTECT(1);
+  return err ? NULL : out;
+};
+
+/* element of a case by name */
+static SEXP bench_elt(SEXP list, const char* name){
+  SEXP names = Rf_getAttrib(list, R_NamesSymbol);
+  for(R_xlen_t i = 0; i < XLENGTH(list); i++){
+    if(strcmp(CHAR(STRING_ELT(names, i)), name) == 0){
+      return VECTOR_ELT(list, i);
+    }
+  }
+  return R_NilValue;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   one (entry, size) in a forked child
+-------------------------------------------------------------------------------- */
+
+typedef struct bench_job {
+  SEXP case_;
+  const R_CallMethodDef* def;
+  double n;
+  double budget;
+  /* results */
+  double calls;
+  double seconds;
+  double ops;
+  int ok;
+} bench_job;
+
+static void bench_body(void* data){
+  bench_job* job = (bench_job*)data;
+  SEXP n = PROTECT(Rf_ScalarReal(job->n));
+  bench_eval_string("set.seed(1)");
+
+  SEXP args = bench_apply(bench_elt(job->case_, "args"), n);
+  if(args == NULL || TYPEOF(args) != VECSXP || XLENGTH(args) != job->def->numArgs){
+    UNPROTECT(1);
+    return;
+  }
+  R_PreserveObject(args);
+  SEXP a[BENCH_MAXARGS];
+  for(int i = 0; i < job->def->numArgs; i++){
+    a[i] = VECTOR_ELT(args, i);
+  }
+
+  SEXP ops = bench_apply(bench_elt(job->case_, "ops"), n);
+  if(ops == NULL){
+    R_ReleaseObject(args);
+    UNPROTECT(1);
+    return;
+  }
+  double per_call = Rf_asReal(ops);
+  int once = Rf_asLogical(bench_elt(job->case_, "once")) == TRUE;
+
+  double calls = 1.0, seconds;
+  for(;;){
+    double t0 = bench_now();
+    for(double i = 0.0; i < calls; i++){
+      bench_invoke(job->def, a);
+    }
+    seconds = bench_now() - t0;
+    if(once || seconds >= job->budget){
+      break;
+    }
+    calls *= 2.0;
+  }
+
+  SEXP done = bench_elt(job->case_, "done");
+  if(done != R_NilValue){
+    bench_apply(done, args);
+  }
+  R_ReleaseObject(args);
+  UNPROTECT(1);
+
+  job->calls = calls;
+  job->seconds = seconds;
+  job->ops = calls * per_call;
+  job->ok = 1;
+};
+
+/* run the job in a child; returns its peak resident set in KB (-1 if it failed) */
+static long bench_fork(bench_job* job){
+  int fd[2];
+  if(pipe(fd) != 0){
+    return -1;
+  }
+  fflush(NULL);
+  pid_t pid = fork();
+  if(pid < 0){
+    close(fd[0]);
+    close(fd[1]);
+    return -1;
+  }
+  if(pid == 0){
+    close(fd[0]);
+    job->ok = 0;
+    R_ToplevelExec(bench_body, job);
+    ssize_t w = write(fd[1], job, sizeof(bench_job));
+    _exit(w == (ssize_t)sizeof(bench_job) ? 0 : 1);
+  }
+  close(fd[1]);
+  bench_job res;
+  ssize_t r = read(fd[0], &res, sizeof(bench_job));
+  close(fd[0]);
+  int status;
+  struct rusage ru;
+  if(wait4(pid, &status, 0, &ru) != pid){
+    return -1;
+  }
+  if(r != (ssize_t)sizeof(bench_job) || !WIFEXITED(status) || WEXITSTATUS(status) != 0){
+    job->ok = 0;
+    return -1;
+  }
+  job->calls = res.calls;
+  job->seconds = res.seconds;
+  job->ops = res.ops;
+  job->ok = res.ok;
+  return ru.ru_maxrss;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   driver
+-------------------------------------------------------------------------------- */
+
+int main(int argc, char** argv){
+  const char* out = argc > 1 ? argv[1] : "bench-C.csv";
+  double lo = argc > 2 ? atof(argv[2]) : 1e3;
+  double hi = argc > 3 ? atof(argv[3]) : 1e7;
+  double budget = argc > 4 ? atof(argv[4]) : 0.2;
+  const char* filter = argc > 5 ? argv[5] : "";
+  const char* cases = argc > 6 ? argv[6] : "cases.R";
+
+#ifdef BENCH_R_HOME
+  setenv("R_HOME", BENCH_R_HOME, 0);
+#endif
+  char* rargv[] = {"bench_calls", "--vanilla", "--silent", "--no-echo"};
+  Rf_initEmbeddedR(4, rargv);
+  R_registerRoutines(R_getEmbeddingDllInfo(), NULL, calls, NULL, NULL);
+
+  if(!bench_eval_string("bench_call <- function(entry, ...) .Call(entry, ..., PACKAGE = \"(embedding)\")")){
+    fprintf(stderr, "bench_calls: could not define bench_call\n");
+    return 1;
+  }
+  SEXP path = PROTECT(Rf_mkString(cases));
+  if(bench_apply(Rf_install("source"), path) == NULL){
+    fprintf(stderr, "bench_calls: could not source %s\n", cases);
+    return 1;
+  }
+  UNPROTECT(1);
+  SEXP list = Rf_findVar(Rf_install("bench_cases"), R_GlobalEnv);
+  if(TYPEOF(list) != VECSXP){
+    fprintf(stderr, "bench_calls: %s does not define bench_cases\n", cases);
+    return 1;
+  }
+  R_PreserveObject(list);
+
+  FILE* csv = fopen(out, "w");
+  if(csv == NULL){
+    fprintf(stderr, "bench_calls: could not open %s\n", out);
+    return 1;
+  }
+  fprintf(csv, "driver,entry,unit,n,calls,seconds,ns_per_op,ops_per_sec,peak_rss_kb,status\n");
+  fflush(csv);
+
+  int k0 = (int)round(log10(lo)), k1 = (int)round(log10(hi));
+  for(R_xlen_t c = 0; c < XLENGTH(list); c++){
+    SEXP case_ = VECTOR_ELT(list, c);
+    const char* entry = CHAR(STRING_ELT(bench_elt(case_, "entry"), 0));
+    const char* unit = CHAR(STRING_ELT(bench_elt(case_, "unit"), 0));
+    if(strstr(entry, filter) == NULL){
+      continue;
+    }
+    const R_CallMethodDef* def = bench_lookup(entry);
+    if(def == NULL){
+      fprintf(stderr, "bench_calls: %s is not registered\n", entry);
+      continue;
+    }
+    double max = Rf_asReal(bench_elt(case_, "max"));
+    for(int k = k0; k <= k1; k++){
+      double n = pow(10.0, k);
+      if(ISNA(max) ? k > k0 : n > max){
+        break;
+      }
+      bench_job job = {case_, def, n, budget, 0.0, 0.0, 0.0, 0};
+      long rss = bench_fork(&job);
+      FILE* streams[2] = {csv, stderr};
+      for(int s = 0; s < 2; s++){
+        if(job.ok){
+          fprintf(streams[s], "C,%s,%s,%.0f,%.0f,%.6f,%.3f,%.1f,%ld,ok\n", entry, unit, n, job.calls,
+                  job.seconds, 1e9 * job.seconds / job.ops, job.ops / job.seconds, rss);
+        } else {
+          fprintf(streams[s], "C,%s,%s,%.0f,NA,NA,NA,NA,NA,error\n", entry, unit, n);
+        }
+      }
+      fflush(csv);
+    }
+  }
+
+  fclose(csv);
+  R_ReleaseObject(list);
+  Rf_endEmbeddedR(0);
+  return 0;
+};
@@ -0,0 +1,146 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Benchmark: future event lists (hold model)
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+#   Each hold operation removes the most imminent event and schedules a new one
+#   an Exponential(1) time later, keeping the number of pending events fixed.
+#   The linked list mirrors slist.c (one malloc per node) with a linear search
+#   for the insertion point.
+#
+#   usage: bench_evlist [ops]   (default 1e6 hold operations per size)
+#
+-------------------------------------------------------------------------------- */
+
+#include "bench.h"
+
+#include "rng.h"
+#include "evlist.h"
+
+
+/* --------------------------------------------------------------------------------
+#   sorted singly-linked list, malloc per node
+-------------------------------------------------------------------------------- */
+
+typedef struct list_node {
+  event             ev;
+  struct list_node* next;
+} list_node;
+
+static void list_push(list_node** head, double time, uint64_t seq){
+  list_node* node = (list_node*)malloc(sizeof(list_node));
+  node->ev.time = time;
+  node->ev.seq = seq;
+  node->ev.type = 0;
+  node->ev.id = 0;
+  list_node** p = head;
+  while(*p != NULL && event_before(&(*p)->ev, &node->ev)){
+    p = &(*p)->next;
+  }
+  node->next = *p;
+  *p = node;
+};
+
+static event list_pop(list_node** head){
+  list_node* node = *head;
+  event e = node->ev;
+  *head = node->next;
+  free(node);
+  return e;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   hold model
+-------------------------------------------------------------------------------- */
+
+static double hold_heap(size_t pending, size_t ops){
+  rngs r;
+  rngs_init(&r);
+  event_heap h;
+  init_event_heap(&h, pending);
+  for(size_t i=0; i<pending; i++){
+    push_event_heap(&h, rngs_exponential(&r, 1.), 0, 0);
+  }
+  double t0 = bench_now();
+  for(size_t i=0; i<ops; i++){
+    event e = pop_event_heap(&h);
+    push_event_heap(&h, e.time + rngs_exponential(&r, 1.), 0, 0);
+  }
+  double t1 = bench_now();
+  bench_sink = peek_event_heap(&h)->time;
+  free_event_heap(&h);
+  return t1 - t0;
+};
+
+static double hold_calendar(size_t pending, size_t ops){
+  rngs r;
+  rngs_init(&r);
+  calendar_queue q;
+  init_calendar_queue(&q);
+  for(size_t i=0; i<pending; i++){
+    push_calendar_queue(&q, rngs_exponential(&r, 1.), 0, 0);
+  }
+  double t0 = bench_now();
+  for(size_t i=0; i<ops; i++){
+    event e = pop_calendar_queue(&q);
+    push_calendar_queue(&q, e.time + rngs_exponential(&r, 1.), 0, 0);
+  }
+  double t1 = bench_now();
+  bench_sink = q.last_time;
+  free_calendar_queue(&q);
+  return t1 - t0;
+};
+
+static double hold_list(size_t pending, size_t ops){
+  rngs r;
+  rngs_init(&r);
+  list_node* head = NULL;
+  uint64_t seq = 0;
+  for(size_t i=0; i<pending; i++){
+    list_push(&head, rngs_exponential(&r, 1.), seq++);
+  }
+  double t0 = bench_now();
+  for(size_t i=0; i<ops; i++){
+    event e = list_pop(&head);
+    list_push(&head, e.time + rngs_exponential(&r, 1.), seq++);
+  }
+  double t1 = bench_now();
+  bench_sink = head->ev.time;
+  while(head != NULL){
+    list_pop(&head);
+  }
+  return t1 - t0;
+};
+
+int main(int argc, char** argv){
+
+  size_t ops = (argc > 1) ? (size_t)atof(argv[1]) : (size_t)1e6;
+  size_t sizes[] = {10, 100, 1000, 10000, 100000, 1000000};
+
+  printf("structure,pending,ops,seconds,ns_per_op\n");
+
+  for(size_t k=0; k<sizeof(sizes)/sizeof(sizes[0]); k++){
+    size_t n = sizes[k];
+    double s;
+
+    s = hold_heap(n, ops);
+    printf("heap,%zu,%zu,%.4f,%.2f\n", n, ops, s, 1e9 * s / (double)ops);
+
+    s = hold_calendar(n, ops);
+    printf("calendar,%zu,%zu,%.4f,%.2f\n", n, ops, s, 1e9 * s / (double)ops);
+
+    /* the linked list is O(n) per operation; cap the work so the run finishes */
+    if(n <= 10000){
+      size_t lops = (n <= 1000) ? ops : ops / 10;
+      s = hold_list(n, lops);
+      printf("list,%zu,%zu,%.4f,%.2f\n", n, lops, s, 1e9 * s / (double)lops);
+    } else {
+      printf("list,%zu,0,NA,NA\n", n);
+    }
+  }
+
+  return 0;
+};
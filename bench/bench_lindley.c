@@ -0,0 +1,75 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Benchmark: delay recursion over many traces, one at a time vs. in lanes
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+#   usage: bench_lindley [n] [m] [threads]   (default 1e6 jobs in each of 64 traces, 1 thread)
+#
+-------------------------------------------------------------------------------- */
+
+#include "bench.h"
+
+#include <string.h>
+
+#include "lindley.h"
+#include "rng.h"
+
+static void report(const char* kernel, size_t n, size_t m, int threads, double secs){
+  double jobs = (double)n * (double)m;
+  printf("%s,%zu,%zu,%d,%.4f,%.3f,%.1f\n", kernel, n, m, threads, secs, 1e9 * secs / jobs, 1e-6 * jobs / secs);
+};
+
+int main(int argc, char** argv){
+
+  size_t n = (argc > 1) ? (size_t)atof(argv[1]) : (size_t)1e6;
+  size_t m = (argc > 2) ? (size_t)atof(argv[2]) : 64;
+  int threads = (argc > 3) ? atoi(argv[3]) : 1;
+
+  double* a = malloc(sizeof(double) * n * m);
+  double* s = malloc(sizeof(double) * n * m);
+  double* d = malloc(sizeof(double) * n * m);
+  double* e = malloc(sizeof(double) * n * m);
+  if(a == NULL || s == NULL || d == NULL || e == NULL){
+    fprintf(stderr, "unable to allocate %zu x %zu traces\n", n, m);
+    return 1;
+  }
+
+  /* Exponential(2) interarrivals and Uniform(1,2) services */
+  rngs r;
+  rngs_init(&r);
+  for(size_t j=0; j<m; j++){
+    double t = 0.;
+    rngs_select_stream(&r, 0);
+    for(size_t i=0; i<n; i++){
+      t += rngs_exponential(&r, 2.);
+      a[i + n * j] = t;
+    }
+    rngs_select_stream(&r, 1);
+    rngs_fill_uniform(&r, 1., 2., s + n * j, n);
+  }
+
+  printf("kernel,n,m,threads,seconds,ns_per_job,mjobs_per_sec\n");
+
+  double t0 = bench_now();
+  for(size_t j=0; j<m; j++){
+    lindley(a + n * j, s + n * j, e + n * j, n, 0.);
+  }
+  report("per_trace", n, m, 1, bench_now() - t0);
+
+  t0 = bench_now();
+  lindley_traces(a, n, s, n, d, n, m, threads);
+  report("lanes", n, m, threads, bench_now() - t0);
+
+  if(memcmp(d, e, sizeof(double) * n * m) != 0){
+    fprintf(stderr, "kernels disagree\n");
+    return 1;
+  }
+
+  free(a);
+  free(s);
+  free(d);
+  free(e);
+  return 0;
+};
@@ -0,0 +1,120 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Benchmark: ax mod m and full-period tests, 32-bit vs. 64-bit paths
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+#   usage: bench_mulmod [n]   (default n = 1e8 steps of x -> ax mod m per kernel)
+#
+-------------------------------------------------------------------------------- */
+
+#include "bench.h"
+
+#include <stdint.h>
+
+#include "primroot.h"
+
+#define M31 2147483647LL
+#define M61 2305843009213693951LL
+
+static void report(const char* kernel, const char* modulus, size_t n, double secs, int64_t x){
+  printf("%s,%s,%zu,%.4f,%.3f,%lld\n", kernel, modulus, n, secs, 1e9 * secs / (double)n, (long long)x);
+};
+
+int main(int argc, char** argv){
+
+  size_t n = (argc > 1) ? (size_t)atof(argv[1]) : (size_t)1e8;
+
+  printf("kernel,modulus,n,seconds,ns_per_op,final_state\n");
+
+  /* x -> 48271 x mod 2^31-1: every kernel should end in the same state */
+  {
+    const int a = 48271, m = (int)M31, q = m / a, r = m % a;
+    int x = 1;
+    double t0 = bench_now();
+    for(size_t i=0; i<n; i++){
+      x = pr_schrage(x, a, q, r, m);
+    }
+    report("schrage32", "2^31-1", n, bench_now() - t0, x);
+  }
+  {
+    int64_t x = 1;
+    double t0 = bench_now();
+    for(size_t i=0; i<n; i++){
+      x = (48271 * x) % M31;
+    }
+    report("product64", "2^31-1", n, bench_now() - t0, x);
+  }
+  {
+    const int64_t a = 48271, q = M31 / a, r = M31 % a;
+    int64_t x = 1;
+    double t0 = bench_now();
+    for(size_t i=0; i<n; i++){
+      x = pr_schrage64(x, a, q, r, M31);
+    }
+    report("schrage64", "2^31-1", n, bench_now() - t0, x);
+  }
+  {
+    uint64_t x = 1;
+    double t0 = bench_now();
+    for(size_t i=0; i<n; i++){
+      x = pr_mul_mod64(x, 48271, M31);
+    }
+    report("mulmod128", "2^31-1", n, bench_now() - t0, (int64_t)x);
+  }
+
+  /* x -> 37 x mod 2^61-1, beyond the reach of the 32-bit path */
+  {
+    const int64_t a = 37, q = M61 / a, r = M61 % a;
+    int64_t x = 1;
+    double t0 = bench_now();
+    for(size_t i=0; i<n; i++){
+      x = pr_schrage64(x, a, q, r, M61);
+    }
+    report("schrage64", "2^61-1", n, bench_now() - t0, x);
+  }
+  {
+    uint64_t x = 1;
+    double t0 = bench_now();
+    for(size_t i=0; i<n; i++){
+      x = pr_mul_mod64(x, 37, M61);
+    }
+    report("mulmod128", "2^61-1", n, bench_now() - t0, (int64_t)x);
+  }
+
+  /* full-period tests of the multipliers 2,...,k+1 (n_ops = k); final_state counts the full-period ones */
+  size_t k = n / 1000 + 1;
+  {
+    int q[PR_MAX_FACTORS];
+    int nq = pr_factor((int)M31 - 1, q);
+    int64_t found = 0;
+    double t0 = bench_now();
+    for(size_t i=0; i<k; i++){
+      found += pr_is_full_period((int)(i + 2), (int)M31, q, nq);
+    }
+    report("full_period32", "2^31-1", k, bench_now() - t0, found);
+  }
+  {
+    uint64_t q[PR_MAX_FACTORS];
+    int nq = pr_factor64(M31 - 1, q);
+    int64_t found = 0;
+    double t0 = bench_now();
+    for(size_t i=0; i<k; i++){
+      found += pr_is_full_period64(i + 2, M31, q, nq);
+    }
+    report("full_period64", "2^31-1", k, bench_now() - t0, found);
+  }
+  {
+    uint64_t q[PR_MAX_FACTORS];
+    double t0 = bench_now();
+    int nq = pr_factor64(M61 - 1, q);
+    int64_t found = 0;
+    for(size_t i=0; i<k; i++){
+      found += pr_is_full_period64(i + 2, M61, q, nq);
+    }
+    report("full_period64", "2^61-1", k, bench_now() - t0, found);
+  }
+
+  return 0;
+};
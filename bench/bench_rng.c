@@ -0,0 +1,61 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Benchmark: Lehmer generator engines (Schrage vs. Mersenne fold vs. SIMD)
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+#   usage: bench_rng [n]   (default n = 1e8 variates per engine)
+#
+-------------------------------------------------------------------------------- */
+
+#include "bench.h"
+
+#include <string.h>
+
+#include "rng.h"
+
+static const char* engine_name[] = {"auto", "schrage", "mersenne", "avx2", "avx512"};
+
+int main(int argc, char** argv){
+
+  size_t n = (argc > 1) ? (size_t)atof(argv[1]) : (size_t)1e8;
+  size_t chunk = 1 << 16; /* fill a cache-resident buffer repeatedly */
+
+  double* ref = malloc(sizeof(double) * chunk);
+  double* buf = malloc(sizeof(double) * chunk);
+
+  printf("engine,n,seconds,ns_per_variate,mvariates_per_sec,identical\n");
+
+  for(int e=RNG_ENGINE_SCHRAGE; e<=RNG_ENGINE_AVX512; e++){
+    if(!rng_engine_available(e)){
+      printf("%s,%zu,NA,NA,NA,NA\n", engine_name[e], n);
+      continue;
+    }
+
+    /* check the first chunk against the Schrage engine */
+    long x_ref = RNG_DEFAULT;
+    long x = RNG_DEFAULT;
+    rng_fill_engine(RNG_ENGINE_SCHRAGE, &x_ref, ref, chunk);
+    rng_fill_engine(e, &x, buf, chunk);
+    int identical = (x == x_ref) && (memcmp(ref, buf, sizeof(double) * chunk) == 0);
+
+    double t0 = bench_now();
+    size_t done = 0;
+    while(done < n){
+      size_t k = (n - done < chunk) ? n - done : chunk;
+      rng_fill_engine(e, &x, buf, k);
+      done += k;
+    }
+    double t1 = bench_now();
+    bench_sink = buf[0];
+
+    double secs = t1 - t0;
+    printf("%s,%zu,%.4f,%.3f,%.1f,%s\n", engine_name[e], n, secs, 1e9 * secs / (double)n,
+           1e-6 * (double)n / secs, identical ? "TRUE" : "FALSE");
+  }
+
+  free(ref);
+  free(buf);
+  return 0;
+};
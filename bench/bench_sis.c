@@ -0,0 +1,113 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Benchmark: program sis1 over many demand traces
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+#   usage: bench_sis [n] [m] [threads]   (default 1e6 intervals in each of 64 traces, 1 thread)
+#
+-------------------------------------------------------------------------------- */
+
+#include "bench.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "sis.h"
+#include "rng.h"
+
+/* the loop of program sis1 with branches and pow(), as a baseline */
+static void sis1_reference(int s, int S, const int* d, size_t n, double* out){
+  double o[SIS_KERNEL_NSTAT] = {0.};
+  long inv = S;
+  for(size_t i=0; i<n; i++){
+    long ord = 0;
+    if(inv < s){
+      ord = S - inv;
+      o[0] += 1.;
+      o[3] += (double)ord;
+    }
+    inv += ord;
+    long dem = d[i];
+    o[4] += (double)dem;
+    if(inv > dem){
+      o[1] += ((double)inv - 0.5 * (double)dem);
+    } else if(dem > 0){
+      o[1] += pow((double)inv, 2.) / (2.0 * dem);
+      o[2] += pow((double)(dem - inv), 2.) / (2.0 * dem);
+    }
+    inv -= dem;
+  }
+  if(inv < S){
+    o[0] += 1.;
+    o[3] += (double)(S - inv);
+  }
+  for(int k=0; k<SIS_KERNEL_NSTAT; k++){
+    out[k] = o[k] / (double)n;
+  }
+};
+
+static void report(const char* kernel, size_t n, size_t m, int threads, double secs){
+  double intervals = (double)n * (double)m;
+  printf("%s,%zu,%zu,%d,%.4f,%.3f,%.1f,%.2f\n", kernel, n, m, threads, secs, 1e9 * secs / intervals,
+         1e-6 * intervals / secs, 1e-9 * intervals * sizeof(int) / secs);
+};
+
+int main(int argc, char** argv){
+
+  size_t n = (argc > 1) ? (size_t)atof(argv[1]) : (size_t)1e6;
+  size_t m = (argc > 2) ? (size_t)atof(argv[2]) : 64;
+  int threads = (argc > 3) ? atoi(argv[3]) : 1;
+
+  int* d = malloc(sizeof(int) * n * m);
+  double* s = malloc(sizeof(double) * m);
+  double* S = malloc(sizeof(double) * m);
+  double* ref = malloc(sizeof(double) * SIS_KERNEL_NSTAT * m);
+  double* one = malloc(sizeof(double) * SIS_KERNEL_NSTAT * m);
+  double* lanes = malloc(sizeof(double) * SIS_KERNEL_NSTAT * m);
+  if(d == NULL || s == NULL || S == NULL || ref == NULL || one == NULL || lanes == NULL){
+    fprintf(stderr, "unable to allocate %zu x %zu traces\n", n, m);
+    return 1;
+  }
+
+  /* Equilikely(10,50) demands (mean 30) and policies around the book's (20,80) */
+  rngs r;
+  rngs_init(&r);
+  rngs_fill_equilikely(&r, 10, 50, d, n * m);
+  for(size_t j=0; j<m; j++){
+    s[j] = (double)(10 + j % 21);
+    S[j] = (double)(60 + j % 41);
+  }
+
+  printf("kernel,n,m,threads,seconds,ns_per_interval,mintervals_per_sec,gb_per_sec\n");
+
+  double t0 = bench_now();
+  for(size_t j=0; j<m; j++){
+    sis1_reference((int)s[j], (int)S[j], d + n * j, n, ref + SIS_KERNEL_NSTAT * j);
+  }
+  report("reference", n, m, 1, bench_now() - t0);
+
+  t0 = bench_now();
+  for(size_t j=0; j<m; j++){
+    sis_trace(s[j], S[j], d + n * j, n, one + SIS_KERNEL_NSTAT * j);
+  }
+  report("per_trace", n, m, 1, bench_now() - t0);
+
+  t0 = bench_now();
+  sis_traces(d, n, m, s, S, lanes, threads);
+  report("lanes", n, m, threads, bench_now() - t0);
+
+  if(memcmp(ref, one, sizeof(double) * SIS_KERNEL_NSTAT * m) != 0 || memcmp(ref, lanes, sizeof(double) * SIS_KERNEL_NSTAT * m) != 0){
+    fprintf(stderr, "kernels disagree\n");
+    return 1;
+  }
+
+  free(d);
+  free(s);
+  free(S);
+  free(ref);
+  free(one);
+  free(lanes);
+  return 0;
+};
@@ -0,0 +1,29 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Output vectors shared by the bulk generators
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "bulk.h"
+
+
+/* --------------------------------------------------------------------------------
+#   the caller's vector, or a new one of length n
+-------------------------------------------------------------------------------- */
+
+SEXP bulk_output(SEXP nR, SEXP outR, int type){
+  if(!Rf_isNull(outR)){
+    if(TYPEOF(outR) != type){
+      Rf_error("'out' should be a %s vector", type == REALSXP ? "numeric" : "integer");
+    }
+    return outR;
+  }
+  double n = Rf_asReal(nR);
+  if(ISNAN(n) || n < 0. || n != floor(n) || n > (double)R_XLEN_T_MAX){
+    Rf_error("'n' should be a non-negative integer");
+  }
+  return Rf_allocVector(type, (R_xlen_t)n);
+};
@@ -0,0 +1,24 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Output vectors shared by the bulk generators
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef BULK_H
+#define BULK_H
+
+#include <R.h>
+#include <Rinternals.h>
+
+
+/* --------------------------------------------------------------------------------
+#   functions
+-------------------------------------------------------------------------------- */
+
+/* output vector for the bulk routines: outR itself if supplied, otherwise a new (unprotected) vector of length nR */
+SEXP bulk_output(SEXP nR, SEXP outR, int type);
+
+#endif
@@ -8,59 +8,241 @@
 -------------------------------------------------------------------------------- */
 
 #include "des-1.h"
+#include "des-3.h" // for rngs external ptrs
+#include "sis.h"   // for the sis1 kernels
 
 
 /* --------------------------------------------------------------------------------
-#   algorithm 1.2.1: calculate delays under FIFO with finite capacity
+#   algorithm 1.2.1: calculate delays under FIFO with infinite capacity
 -------------------------------------------------------------------------------- */
 
 SEXP des_1_2_1_C(SEXP arrivals, SEXP services){
-  int n = LENGTH(arrivals);
-  if(LENGTH(services) != n){
+  R_xlen_t n = XLENGTH(arrivals);
+  if(XLENGTH(services) != n){
     error("'arrivals' and 'services' vectors must be the same length\n");
   }
 
-  /* vector of service completions (departures) */
-  double* c = (double*)calloc(n+1,sizeof(double));
-  c[0] = 0.;
+  /* delays (the output); the departure time of the previous job is carried in a register */
+  SEXP d = PROTECT(allocVector(REALSXP,n));
+  lindley(REAL(arrivals), REAL(services), REAL(d), (size_t)n, 0.);
 
-  /* vector of arrivals (a) and services times (s) */
-  double* a = (double*)calloc(n+1,sizeof(double));
-  double* s = (double*)calloc(n+1,sizeof(double));
+  UNPROTECT(1);
+  return d;
+};
 
-  memcpy(a+1,REAL(arrivals),sizeof(double)*n);
-  memcpy(s+1,REAL(services),sizeof(double)*n);
+/* number of rows and columns of a numeric vector (one column) or matrix */
+static void trace_dim(SEXP x, R_xlen_t* n, R_xlen_t* m){
+  SEXP dim = Rf_getAttrib(x, R_DimSymbol);
+  if(Rf_length(dim) == 2){
+    *n = INTEGER(dim)[0];
+    *m = INTEGER(dim)[1];
+  } else {
+    *n = XLENGTH(x);
+    *m = 1;
+  }
+};
 
-  /* departure times (the output) */
-  SEXP d = PROTECT(allocVector(REALSXP,n));
-  double* d_i = REAL(d); /* d_i is the departure time of job i */
+SEXP des_1_2_1_batch_C(SEXP arrivals, SEXP services, SEXP outR, SEXP threadsR){
 
-  int i = 0;
+  if(!Rf_isReal(arrivals) || !Rf_isReal(services)){
+    error("arrivals and service times must be numeric (float) values\n");
+  }
+  int threads = Rf_asInteger(threadsR);
+  if(threads == NA_INTEGER || threads < 1){
+    error("'threads' should be a positive integer\n");
+  }
 
-  while(i < n){
+  /* a trace with one column is shared by every trace of the other */
+  R_xlen_t na, ma, ns, ms;
+  trace_dim(arrivals, &na, &ma);
+  trace_dim(services, &ns, &ms);
+  if(na != ns){
+    error("'arrivals' and 'services' must have the same number of rows\n");
+  }
+  if(ma != ms && ma != 1 && ms != 1){
+    error("'arrivals' and 'services' must have the same number of columns, or one of them a single column\n");
+  }
+  R_xlen_t n = na;
+  R_xlen_t m = (ma > ms) ? ma : ms;
+
+  SEXP d;
+  if(Rf_isNull(outR)){
+    /* a single trace too long for a matrix is returned as a vector */
+    d = PROTECT((n <= INT_MAX) ? allocMatrix(REALSXP, (int)n, (int)m) : allocVector(REALSXP, n * m));
+  } else {
+    if(!Rf_isReal(outR) || XLENGTH(outR) != n * m){
+      error("'out' should be a numeric vector with one element per job of every trace\n");
+    }
+    d = PROTECT(outR);
+  }
+
+  lindley_traces(REAL(arrivals), (ma == 1) ? 0 : (size_t)n, REAL(services), (ms == 1) ? 0 : (size_t)n, REAL(d), (size_t)n, (size_t)m, threads);
+
+  UNPROTECT(1);
+  return d;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   single-server service node with finite capacity and any queue discipline (trace driven):
+#   jobs that arrive to a full node are rejected; when service ends the next job is taken
+#   from the queue by the discipline. FIFO with infinite capacity gives algorithm 1.2.1
+-------------------------------------------------------------------------------- */
 
-    i++;
-    double a_i = a[i];
+#define SSQ_GENERAL_NSTAT 10
 
-    if(a_i < c[i-1]){
-      /* calculate delay for job i */
-      d_i[i-1] = c[i-1] - a_i;
+static const char* ssq_general_names[SSQ_GENERAL_NSTAT] = {"n", "served", "rejected", "r", "w", "d", "s", "l", "q", "x"};
+
+SEXP des_ssq_general_C(SEXP arrivals, SEXP services, SEXP disciplineR, SEXP capacityR, SEXP priorityR, SEXP rngR){
+
+  R_xlen_t n = XLENGTH(arrivals);
+  if(XLENGTH(services) != n){
+    error("'arrivals' and 'services' vectors must be the same length\n");
+  }
+  int discipline = Rf_asInteger(disciplineR);
+  if(discipline == NA_INTEGER || discipline < JQ_FIFO || discipline > JQ_PRIORITY){
+    error("unknown queue discipline\n");
+  }
+  double capacity = Rf_asReal(capacityR);
+  if(ISNAN(capacity) || capacity < 1. || (R_FINITE(capacity) && capacity != floor(capacity))){
+    error("'capacity' should be a positive integer or Inf\n");
+  }
+  int64_t cap = (capacity > 9e18) ? INT64_MAX : (int64_t)capacity;
+
+  const double* a = REAL(arrivals);
+  const double* s = REAL(services);
+  const double* key = s;
+  if(discipline == JQ_PRIORITY){
+    if(Rf_isNull(priorityR) || XLENGTH(priorityR) != n){
+      error("'priority' should give the priority of every job\n");
+    }
+    key = REAL(priorityR);
+    for(R_xlen_t i=0; i<n; i++){
+      if(!R_FINITE(key[i])){
+        error("priorities should be finite (job %.0f)\n", (double)(i + 1));
+      }
+    }
+  }
+  for(R_xlen_t i=0; i<n; i++){
+    if(ISNAN(a[i]) || ISNAN(s[i]) || s[i] < 0. || (i > 0 && a[i] < a[i-1])){
+      error("arrival times should be non-decreasing and service times non-negative (job %.0f)\n", (double)(i + 1));
+    }
+  }
+  rngs* r = NULL;
+  if(discipline == JQ_SIRO){
+    if(Rf_isNull(rngR)){
+      error("service in random order needs 'rng'\n");
+    }
+    r = get_rngs(rngR);
+  }
+
+  SEXP d = PROTECT(allocVector(REALSXP,n));
+  double* d_i = REAL(d);
+
+  jobqueue q;
+  if(!jq_init(&q, discipline, 1024)){
+    error("unable to allocate memory for the queue\n");
+  }
+
+  double completion = 0.;   /* departure time of the job in service        */
+  double end = 0.;          /* last departure                              */
+  int64_t number = 0;       /* number in the node (queue and service)      */
+  int64_t served = 0;
+  int64_t rejected = 0;
+  R_xlen_t i = 0;           /* next arrival                                */
+  int oom = 0;
+
+  struct {                  /* sum over jobs served of ... */
+    double d;               /*   delay times               */
+    double w;               /*   wait times                */
+    double s;               /*   service times             */
+  } sum = {0.0, 0.0, 0.0};
+
+  /* departures at the same time as an arrival are processed first */
+  while(i < n || number > 0){
+
+    if(number > 0 && (i == n || completion <= a[i])){
+      /* departure: start the next job, if any */
+      number--;
+      end = completion;
+      if(number > 0){
+        int64_t j = jq_pop(&q, r);
+        double delay = completion - a[j];
+        d_i[j] = delay;
+        completion = a[j] + delay + s[j];
+        sum.d += delay;
+        sum.w += delay + s[j];
+        sum.s += s[j];
+        served++;
+      }
     } else {
-      /* job i has no delay */
-      d_i[i-1] = 0.;
+      /* arrival of job i: rejected, served at once, or queued */
+      if(number >= cap){
+        d_i[i] = NA_REAL;
+        rejected++;
+      } else if(number == 0){
+        d_i[i] = 0.;
+        completion = a[i] + 0. + s[i];
+        sum.w += s[i];
+        sum.s += s[i];
+        served++;
+        number++;
+      } else {
+        if(!jq_push(&q, (int64_t)i, key[i])){
+          oom = 1;
+          break;
+        }
+        number++;
+      }
+      i++;
     }
+  }
 
-    /* calculate departure time for job i */
-    c[i] = a_i + d_i[i-1] + s[i];
+  jq_free(&q);
+  if(oom){
+    error("unable to allocate memory for the queue\n");
   }
 
-  /* free memory/unprotect and return */
-  free(c);
-  free(a);
-  free(s);
-  UNPROTECT(1);
+  if(n > 0 && a[n-1] > end){
+    end = a[n-1];
+  }
+  double ns = (double)served;
+
+  SEXP stats = PROTECT(allocVector(REALSXP,SSQ_GENERAL_NSTAT));
+  double* x = REAL(stats);
+  x[0] = (double)n;
+  x[1] = ns;
+  x[2] = (double)rejected;
+  x[3] = (n > 0) ? a[n-1] / (double)n : NA_REAL;  /* interarrival time */
+  x[4] = sum.w / ns;                              /* wait              */
+  x[5] = sum.d / ns;                              /* delay             */
+  x[6] = sum.s / ns;                              /* service time      */
+  x[7] = sum.w / end;                             /* # in the node     */
+  x[8] = sum.d / end;                             /* # in the queue    */
+  x[9] = sum.s / end;                             /* utilization       */
+  for(int k=3; k<SSQ_GENERAL_NSTAT; k++){
+    if(ISNAN(x[k])){
+      x[k] = NA_REAL;
+    }
+  }
 
-  return d;
+  SEXP stat_names = PROTECT(allocVector(STRSXP,SSQ_GENERAL_NSTAT));
+  for(int k=0; k<SSQ_GENERAL_NSTAT; k++){
+    SET_STRING_ELT(stat_names, k, mkChar(ssq_general_names[k]));
+  }
+  Rf_namesgets(stats, stat_names);
+
+  SEXP out = PROTECT(allocVector(VECSXP,2));
+  SET_VECTOR_ELT(out,0,d);
+  SET_VECTOR_ELT(out,1,stats);
+
+  SEXP names = PROTECT(allocVector(STRSXP,2));
+  SET_STRING_ELT(names,0,mkChar("d"));
+  SET_STRING_ELT(names,1,mkChar("stats"));
+  Rf_namesgets(out,names);
+
+  UNPROTECT(5);
+  return out;
 };
 
 
@@ -68,6 +250,27 @@ SEXP des_1_2_1_C(SEXP arrivals, SEXP services){
 #   program ssq1: a computational model of a single-server FIFO service node with infinite capacity
 -------------------------------------------------------------------------------- */
 
+SEXP ssq1_output(const ssq1_state* st){
+
+  double n = (double)st->n;
+
+  SEXP result = PROTECT(Rf_allocVector(REALSXP, 4));
+  REAL(result)[0] = st->a / n;     /* interarrival time */
+  REAL(result)[1] = st->sum.s / n; /* service time      */
+  REAL(result)[2] = st->sum.d / n; /* delay             */
+  REAL(result)[3] = st->sum.w / n; /* wait              */
+
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP, 4));
+  Rf_namesgets(result, nms);
+  SET_STRING_ELT(nms, 0, mkChar("r"));
+  SET_STRING_ELT(nms, 1, mkChar("s"));
+  SET_STRING_ELT(nms, 2, mkChar("d"));
+  SET_STRING_ELT(nms, 3, mkChar("w"));
+
+  UNPROTECT(2);
+  return result;
+};
+
 SEXP des_ssq1_C(SEXP df){
 
   /* sanity checks */
@@ -78,73 +281,71 @@ SEXP des_ssq1_C(SEXP df){
   SEXP arrival_in = PROTECT(VECTOR_ELT(df, 0));
   SEXP service_in = PROTECT(VECTOR_ELT(df, 1));
 
-  double* a_ptr = REAL(arrival_in);
-  double* s_ptr = REAL(service_in);
-
   if(!Rf_isReal(arrival_in) || !Rf_isReal(service_in)){
     error("arrivals and service times must be numeric (float) values\n");
   }
 
+  double* a_ptr = REAL(arrival_in);
+  double* s_ptr = REAL(service_in);
+
   /* number of jobs */
-  int n = Rf_length(arrival_in);
-
-  /* variables for job i */
-  double a_i = 0.; /* arrival time */
-  double d_i = 0.; /* delay in queue */
-  double s_i = 0.; /* service time */
-  double w_i = 0.; /* wait (delay + service) */
-  double c_i = 0.; /* departure time */
-
-  /* time-averaged statistics */
-  struct {                         /* sum of ...           */
-    double d;                      /*   delay times        */
-    double w;                      /*   wait times         */
-    double s;                      /*   service times      */
-    double r;                      /*   interarrival times */
-  } sum = {0.0, 0.0, 0.0, 0.0};
+  R_xlen_t n = XLENGTH(arrival_in);
 
   /* trace-driven simulation */
-  for(int i=0; i<n; i++){
+  ssq1_state st;
+  ssq1_init(&st);
+  for(R_xlen_t i=0; i<n; i++){
+    ssq1_step(&st, a_ptr[i], s_ptr[i]);
+  }
 
-    a_i = a_ptr[i];
+  UNPROTECT(2);
+  return ssq1_output(&st);
+};
 
-    if(a_i < c_i){
-      /* delay in queue */
-      d_i = c_i - a_i;
-    } else {
-      /* no delay */
-      d_i = 0.;
-    }
 
-    s_i = s_ptr[i];
-    w_i = d_i + s_i;
-    c_i = a_i + w_i; /* time of departure */
+/* --------------------------------------------------------------------------------
+#   program ssq1 with the trace streamed from a file: (arrival, service) pairs are handed
+#   to the recursion one chunk at a time as they are mapped or parsed
+-------------------------------------------------------------------------------- */
 
-    sum.d += d_i;
-    sum.w += w_i;
-    sum.s += s_i;
+static void ssq1_chunk(void* ctx, const double* pairs, size_t n){
+  ssq1_state* st = (ssq1_state*)ctx;
+  for(size_t i=0; i<n; i++){
+    ssq1_step(st, pairs[2*i], pairs[2*i + 1]);
   }
+};
 
-  sum.d /= (double)n;
-  sum.w /= (double)n;
-  sum.s /= (double)n;
-  sum.r = a_i / (double)n;
+SEXP des_ssq1_file_C(SEXP pathR, SEXP formatR, SEXP chunkR){
 
-  SEXP result = PROTECT(Rf_allocVector(REALSXP, 4));
-  REAL(result)[0] = sum.r;
-  REAL(result)[1] = sum.s;
-  REAL(result)[2] = sum.d;
-  REAL(result)[3] = sum.w;
+  if(!Rf_isString(pathR) || Rf_length(pathR) != 1){
+    error("'path' should be a single file name\n");
+  }
+  const char* path = CHAR(STRING_ELT(pathR, 0));
+  int format = Rf_asInteger(formatR);
+  double chunk = Rf_asReal(chunkR);
+  if(ISNAN(chunk) || chunk < 1. || chunk > (double)(1 << 26)){
+    error("'chunk' should be an integer in 1,...,2^26\n");
+  }
 
-  SEXP nms = PROTECT(Rf_allocVector(STRSXP, 4));
-  Rf_namesgets(result, nms);
-  SET_STRING_ELT(nms, 0, mkChar("r"));
-  SET_STRING_ELT(nms, 1, mkChar("s"));
-  SET_STRING_ELT(nms, 2, mkChar("d"));
-  SET_STRING_ELT(nms, 3, mkChar("w"));
+  ssq1_state st;
+  ssq1_init(&st);
 
-  UNPROTECT(4);
-  return result;
+  /* the reader owns a file and buffers, so errors are returned to be raised here */
+  char msg[256];
+  int ok;
+  if(format == TRACE_BINARY){
+    ok = trace_read_binary(path, (size_t)chunk, ssq1_chunk, &st, msg, sizeof(msg));
+  } else {
+    ok = trace_read_text(path, (size_t)chunk, ssq1_chunk, &st, msg, sizeof(msg));
+  }
+  if(!ok){
+    error("%s\n", msg);
+  }
+  if(st.n == 0){
+    error("'%s' contains no jobs\n", path);
+  }
+
+  return ssq1_output(&st);
 };
 
 
@@ -152,144 +353,266 @@ SEXP des_ssq1_C(SEXP df){
 #   algorithm 1.3.1: compute discrete time evolution of inventory level for simple system (w/back ordering & no delivery lag)
 -------------------------------------------------------------------------------- */
 
-SEXP des_1_3_1_C(SEXP demands, SEXP sR, SEXP SR){
+/* levels l and orders o of intervals i0,...,i0+len-1 of a trace of n demands, given the level lev at the
+   start of interval i0; the last interval of the trace gets the terminal order that fills the inventory
+   up to S. Returns the level at the end of the block (before any terminal order) */
+static int alg131_block(const int* d, R_xlen_t i0, R_xlen_t len, R_xlen_t n, int s, int S, int lev, int* l, int* o){
+  for(R_xlen_t k=0; k<len; k++){
+    int ord = (lev < s) ? S - lev : 0;
+    lev = lev + ord - d[i0 + k];
+    l[k] = lev;
+    o[k] = ord;
+  }
+  /* terminal order to fill up inventory */
+  if(len > 0 && i0 + len == n){
+    o[len-1] = S - l[len-1];
+    l[len-1] = S;
+  }
+  return lev;
+};
+
+static SEXP alg131_list(SEXP lout, SEXP oout){
+  SEXP result = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(result,0,lout);
+  SET_VECTOR_ELT(result,1,oout);
+
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP, 2));
+  Rf_namesgets(result, nms);
+  SET_STRING_ELT(nms, 0, Rf_mkChar("l"));
+  SET_STRING_ELT(nms, 1, Rf_mkChar("o"));
+
+  UNPROTECT(2);
+  return result;
+};
+
+/* levels and orders are written straight into the result (or into out, a list(l, o) of integer vectors) */
+SEXP des_1_3_1_C(SEXP demands, SEXP sR, SEXP SR, SEXP outR){
 
   int s = Rf_asInteger(sR);
   int S = Rf_asInteger(SR);
 
-  int* d_ptr = INTEGER(demands);
-  int d;
+  R_xlen_t n = XLENGTH(demands);
+
+  SEXP result;
+  if(Rf_isNull(outR)){
+    SEXP lout = PROTECT(Rf_allocVector(INTSXP,n));
+    SEXP oout = PROTECT(Rf_allocVector(INTSXP,n));
+    result = alg131_list(lout, oout);
+    UNPROTECT(2);
+    PROTECT(result);
+  } else {
+    if(TYPEOF(outR) != VECSXP || XLENGTH(outR) != 2 ||
+       TYPEOF(VECTOR_ELT(outR,0)) != INTSXP || XLENGTH(VECTOR_ELT(outR,0)) != n ||
+       TYPEOF(VECTOR_ELT(outR,1)) != INTSXP || XLENGTH(VECTOR_ELT(outR,1)) != n){
+      error("'out' should be a list of two integer vectors with one element per demand\n");
+    }
+    result = PROTECT(outR);
+  }
 
-  int n = Rf_length(demands);
+  alg131_block(INTEGER(demands), 0, n, n, s, S, S, INTEGER(VECTOR_ELT(result,0)), INTEGER(VECTOR_ELT(result,1)));
 
-  /* we will return the inventory level and orders */
-  int* l = (int*)calloc(n+1,sizeof(int));
-  int* o = (int*)calloc(n,sizeof(int));
+  UNPROTECT(1);
+  return result;
+};
 
-  l[0] = S;
-  int i = 0;
+/* interval indices (from 1) as integers, or doubles for traces longer than INT_MAX */
+static SEXP alg131_index(R_xlen_t len, R_xlen_t n){
+  return Rf_allocVector((n <= INT_MAX) ? INTSXP : REALSXP, len);
+};
 
-  while(i < n){
-    i++;
-    if(l[i-1] < s){
-      o[i-1] = S - l[i-1];
-    } else {
-      o[i-1] = 0;
-    }
-    d = d_ptr[i-1];
-    l[i] = l[i-1] + o[i-1] - d;
+static void alg131_set_index(SEXP x, R_xlen_t k, R_xlen_t i){
+  if(TYPEOF(x) == INTSXP){
+    INTEGER(x)[k] = (int)(i + 1);
+  } else {
+    REAL(x)[k] = (double)(i + 1);
   }
+};
 
-  /* terminal order to fill up inventory */
-  i = n;
-  o[i-1] = S - l[i];
-  l[i] = S;
+#define ALG131_TILE 4096 /* intervals computed at a time by the change-point and streaming versions */
 
-  SEXP lout = PROTECT(Rf_allocVector(INTSXP,n));
-  SEXP oout = PROTECT(Rf_allocVector(INTSXP,n));
+/* change-points: the intervals at which the level changes (run-length encoding) and the nonzero orders;
+   two passes over the recursion (count, then fill) so no buffer grows with the trace */
+SEXP des_1_3_1_changes_C(SEXP demands, SEXP sR, SEXP SR){
 
-  int* lout_ptr = INTEGER(lout);
-  int* oout_ptr = INTEGER(oout);
+  int s = Rf_asInteger(sR);
+  int S = Rf_asInteger(SR);
 
-  memcpy(lout_ptr,&l[1],sizeof(int)*n);
-  memcpy(oout_ptr,o,sizeof(int)*n);
+  const int* d = INTEGER(demands);
+  R_xlen_t n = XLENGTH(demands);
 
-  SEXP result = PROTECT(Rf_allocVector(VECSXP, 2));
-  SET_VECTOR_ELT(result,0,lout);
-  SET_VECTOR_ELT(result,1,oout);
+  int l[ALG131_TILE], o[ALG131_TILE];
 
-  SEXP nms = PROTECT(Rf_allocVector(STRSXP, 2));
-  Rf_namesgets(result, nms);
-  SET_STRING_ELT(nms, 0, Rf_mkChar("l"));
-  SET_STRING_ELT(nms, 1, Rf_mkChar("o"));
+  R_xlen_t nl = 0, no = 0;
+  int lev = S, prev = S;
+  for(R_xlen_t i0=0; i0<n; i0+=ALG131_TILE){
+    R_xlen_t len = (n - i0 < ALG131_TILE) ? n - i0 : ALG131_TILE;
+    lev = alg131_block(d, i0, len, n, s, S, lev, l, o);
+    for(R_xlen_t k=0; k<len; k++){
+      nl += (i0 + k == 0 || l[k] != prev);
+      no += (o[k] != 0);
+      prev = l[k];
+    }
+  }
 
-  UNPROTECT(4);
-  free(l);
-  free(o);
+  SEXP lt = PROTECT(alg131_index(nl, n));
+  SEXP lv = PROTECT(Rf_allocVector(INTSXP, nl));
+  SEXP ot = PROTECT(alg131_index(no, n));
+  SEXP ov = PROTECT(Rf_allocVector(INTSXP, no));
+
+  nl = 0;
+  no = 0;
+  lev = S;
+  prev = S;
+  for(R_xlen_t i0=0; i0<n; i0+=ALG131_TILE){
+    R_xlen_t len = (n - i0 < ALG131_TILE) ? n - i0 : ALG131_TILE;
+    lev = alg131_block(d, i0, len, n, s, S, lev, l, o);
+    for(R_xlen_t k=0; k<len; k++){
+      if(i0 + k == 0 || l[k] != prev){
+        alg131_set_index(lt, nl, i0 + k);
+        INTEGER(lv)[nl++] = l[k];
+      }
+      if(o[k] != 0){
+        alg131_set_index(ot, no, i0 + k);
+        INTEGER(ov)[no++] = o[k];
+      }
+      prev = l[k];
+    }
+  }
+
+  SEXP result = PROTECT(Rf_allocVector(VECSXP, 4));
+  SET_VECTOR_ELT(result,0,lt);
+  SET_VECTOR_ELT(result,1,lv);
+  SET_VECTOR_ELT(result,2,ot);
+  SET_VECTOR_ELT(result,3,ov);
+
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP, 4));
+  Rf_namesgets(result, nms);
+  SET_STRING_ELT(nms, 0, Rf_mkChar("l_start"));
+  SET_STRING_ELT(nms, 1, Rf_mkChar("l"));
+  SET_STRING_ELT(nms, 2, Rf_mkChar("o_at"));
+  SET_STRING_ELT(nms, 3, Rf_mkChar("o"));
 
+  UNPROTECT(6);
   return result;
 };
 
+/* streaming: f(l, o, start) is called with the levels and orders of each chunk of intervals, start being
+   the index (from 1) of its first interval; fresh vectors are passed each time, so f may keep them */
+SEXP des_1_3_1_stream_C(SEXP demands, SEXP sR, SEXP SR, SEXP fR, SEXP chunkR, SEXP rho){
+
+  int s = Rf_asInteger(sR);
+  int S = Rf_asInteger(SR);
+
+  if(!Rf_isFunction(fR)){
+    error("'callback' should be a function\n");
+  }
+  if(!Rf_isEnvironment(rho)){
+    error("'rho' should be an environment\n");
+  }
+  double chunk = Rf_asReal(chunkR);
+  if(ISNAN(chunk) || chunk < 1. || chunk > (double)R_XLEN_T_MAX){
+    error("'chunk' should be a positive integer\n");
+  }
+  R_xlen_t size = (R_xlen_t)chunk;
+
+  const int* d = INTEGER(demands);
+  R_xlen_t n = XLENGTH(demands);
+
+  int lev = S;
+  for(R_xlen_t i0=0; i0<n; i0+=size){
+    R_xlen_t len = (n - i0 < size) ? n - i0 : size;
+    SEXP lout = PROTECT(Rf_allocVector(INTSXP, len));
+    SEXP oout = PROTECT(Rf_allocVector(INTSXP, len));
+    lev = alg131_block(d, i0, len, n, s, S, lev, INTEGER(lout), INTEGER(oout));
+    SEXP start = PROTECT(Rf_ScalarReal((double)(i0 + 1)));
+    SEXP call = PROTECT(Rf_lang4(fR, lout, oout, start));
+    Rf_eval(call, rho);
+    UNPROTECT(4);
+  }
+
+  return R_NilValue;
+};
+
 
 /* --------------------------------------------------------------------------------
 #   program sis1: simulates a simple (s,S) inventory system using demand as input argument
 -------------------------------------------------------------------------------- */
 
-SEXP des_sis1_C(SEXP demands, SEXP sR, SEXP SR){
-
-  int s = Rf_asInteger(sR);
-  int S = Rf_asInteger(SR);
-
+static void sis1_check_policy(int s, int S){
+  if(s == NA_INTEGER || S == NA_INTEGER){
+    Rf_error("'s' and 'S' should be integers");
+  }
   if(s >= S){
     Rf_error("please set s < S");
   }
   if(s < 0 || S < 0){
     Rf_error("inputs must be positive");
   }
+};
 
-  /* pointer to demand trace */
-  int* d_ptr = INTEGER(demands);
-  int n = Rf_length(demands);
-
-  /* time interval index */
-  int i = 0;
-  /* current inventory level */
-  int inv = S;
-  /* amount of demand */
-  int dem;
-  /* amount of orders */
-  int ord;
-
-  /* output vector */
-  SEXP output = PROTECT(Rf_allocVector(REALSXP, 5));
-  SEXP nms = PROTECT(Rf_allocVector(STRSXP, 5));
-  Rf_namesgets(output, nms);
-  SET_STRING_ELT(nms, 0, Rf_mkChar("setup"));
-  SET_STRING_ELT(nms, 1, Rf_mkChar("holding"));
-  SET_STRING_ELT(nms, 2, Rf_mkChar("shortage"));
-  SET_STRING_ELT(nms, 3, Rf_mkChar("order"));
-  SET_STRING_ELT(nms, 4, Rf_mkChar("demand"));
-
-  double* output_ptr = REAL(output);
-
-  /* iterate over demands */
-  while(i < n){
-    i++;
-
-    if(inv < s){
-      ord = S - inv;
-      output_ptr[0] += 1.; // setup
-      output_ptr[3] += (double)ord; // order
-    } else {
-      ord = 0;
+static void sis1_check_demands(SEXP demands){
+  const int* d = INTEGER(demands);
+  for(R_xlen_t i=0; i<XLENGTH(demands); i++){
+    if(d[i] == NA_INTEGER || d[i] < 0){
+      Rf_error("'demands' should be non-negative integers");
     }
+  }
+};
 
-    inv += ord; // no delivery lag
-    dem = d_ptr[i-1];
-    output_ptr[4] += (double)dem;
+static SEXP sis1_names(void){
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP, SIS_NSTAT));
+  for(int k=0; k<SIS_NSTAT; k++){
+    SET_STRING_ELT(nms, k, Rf_mkChar(sis_stat_names[k]));
+  }
+  UNPROTECT(1);
+  return nms;
+};
 
-    if(inv > dem){
-      output_ptr[1] += ((double)inv - 0.5 * (double)dem);
-    } else {
-      output_ptr[1] +=  pow((double)inv,2.) / (2.0 * dem);
-      output_ptr[2] +=  pow((double)(dem - inv),2.) / (2.0 * dem);
-    }
-    inv -= dem;
+SEXP des_sis1_C(SEXP demands, SEXP sR, SEXP SR){
+
+  int s = Rf_asInteger(sR);
+  int S = Rf_asInteger(SR);
+  sis1_check_policy(s, S);
+  sis1_check_demands(demands);
+
+  /* accumulators are kept in the kernel (sis.c) and only the averages are written out */
+  SEXP output = PROTECT(Rf_allocVector(REALSXP, SIS_NSTAT));
+  sis_trace((double)s, (double)S, INTEGER(demands), (size_t)XLENGTH(demands), REAL(output));
+  Rf_namesgets(output, sis1_names());
+
+  UNPROTECT(1);
+  return output;
+};
+
+SEXP des_sis1_batch_C(SEXP demands, SEXP sR, SEXP SR, SEXP threadsR){
+
+  int threads = Rf_asInteger(threadsR);
+  if(threads == NA_INTEGER || threads < 1){
+    Rf_error("'threads' should be a positive integer");
   }
 
-  /* final time step */
-  if(inv < S){
-    ord = S - inv; // match the final inventory
-    output_ptr[0] += 1.;
-    output_ptr[3] += (double)ord;
-    inv += ord;
+  R_xlen_t n, m;
+  trace_dim(demands, &n, &m);
+  if(XLENGTH(sR) != m || XLENGTH(SR) != m){
+    Rf_error("'s' and 'S' should have one element per trace");
   }
+  sis1_check_demands(demands);
+
+  double* s = (double*)R_alloc(m, sizeof(double));
+  double* S = (double*)R_alloc(m, sizeof(double));
+  for(R_xlen_t j=0; j<m; j++){
+    sis1_check_policy(INTEGER(sR)[j], INTEGER(SR)[j]);
+    s[j] = (double)INTEGER(sR)[j];
+    S[j] = (double)INTEGER(SR)[j];
+  }
+
+  /* one column of statistics per trace */
+  SEXP output = PROTECT(Rf_allocMatrix(REALSXP, SIS_NSTAT, (int)m));
+  sis_traces(INTEGER(demands), (size_t)n, (size_t)m, s, S, REAL(output), threads);
 
-  output_ptr[0] /= (double)n;
-  output_ptr[1] /= (double)n;
-  output_ptr[2] /= (double)n;
-  output_ptr[3] /= (double)n;
-  output_ptr[4] /= (double)n;
+  SEXP dn = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(dn, 0, sis1_names());
+  Rf_setAttrib(output, R_DimNamesSymbol, dn);
 
   UNPROTECT(2);
   return output;
@@ -12,26 +12,85 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <stdint.h>
 
 #include <R.h>
 #include <Rinternals.h>
 #include <Rmath.h>
 
+#include "lindley.h"
+#include "tracefile.h" // for streaming traces from files
+#include "jobqueue.h"
+
+
+/* --------------------------------------------------------------------------------
+#   program ssq1, one job at a time
+-------------------------------------------------------------------------------- */
+
+typedef struct ssq1_state {
+  int64_t n;       /* number of jobs        */
+  double  a;       /* last arrival time     */
+  double  c;       /* last departure time   */
+  struct {         /* sum of ...            */
+    double d;      /*   delay times         */
+    double w;      /*   wait times          */
+    double s;      /*   service times       */
+  } sum;
+} ssq1_state;
+
+static inline void ssq1_init(ssq1_state* st){
+  memset(st, 0, sizeof(ssq1_state));
+};
+
+/* job i arrives at a_i and needs service s_i */
+static inline void ssq1_step(ssq1_state* st, const double a_i, const double s_i){
+  double d_i = (a_i < st->c) ? st->c - a_i : 0.; /* delay in queue */
+  double w_i = d_i + s_i;                        /* wait           */
+  st->c = a_i + w_i;                             /* departure      */
+  st->a = a_i;
+  st->sum.d += d_i;
+  st->sum.w += w_i;
+  st->sum.s += s_i;
+  st->n++;
+};
+
+/* named vector with the job-averaged interarrival time (r), service time (s), delay (d), and wait (w) */
+SEXP ssq1_output(const ssq1_state* st);
+
 
 /* --------------------------------------------------------------------------------
 #   functions
 -------------------------------------------------------------------------------- */
 
-/* algorithm 1.2.1: calculate delays under FIFO with finite capacity */
+/* algorithm 1.2.1: calculate delays under FIFO with infinite capacity */
 SEXP des_1_2_1_C(SEXP arrivals, SEXP services);
 
+/* algorithm 1.2.1 over the columns of arrival and service matrices, written into out (if not NULL) or a new matrix */
+SEXP des_1_2_1_batch_C(SEXP arrivals, SEXP services, SEXP outR, SEXP threadsR);
+
+/* single-server service node with finite capacity and any queue discipline (JQ_* in jobqueue.h), trace driven */
+SEXP des_ssq_general_C(SEXP arrivals, SEXP services, SEXP disciplineR, SEXP capacityR, SEXP priorityR, SEXP rngR);
+
 /* program ssq1: a computational model of a single-server FIFO service node with infinite capacity */
 SEXP des_ssq1_C(SEXP df);
 
+/* program ssq1 streaming (arrival, service) pairs from a file in format TRACE_BINARY or TRACE_TEXT */
+SEXP des_ssq1_file_C(SEXP pathR, SEXP formatR, SEXP chunkR);
+
 /* algorithm 1.3.1: compute discrete time evolution of inventory level for simple system (w/back ordering & no delivery lag) */
-SEXP des_1_3_1_C(SEXP demands, SEXP sR, SEXP SR);
+SEXP des_1_3_1_C(SEXP demands, SEXP sR, SEXP SR, SEXP outR);
+
+/* algorithm 1.3.1 returning only the change-points of the inventory level and the nonzero orders */
+SEXP des_1_3_1_changes_C(SEXP demands, SEXP sR, SEXP SR);
+
+/* algorithm 1.3.1 passing the levels and orders to an R function in chunks of intervals */
+SEXP des_1_3_1_stream_C(SEXP demands, SEXP sR, SEXP SR, SEXP fR, SEXP chunkR, SEXP rho);
 
 /* program sis1: simulates a simple (s,S) inventory system using demand as input argument */
 SEXP des_sis1_C(SEXP demands, SEXP sR, SEXP SR);
 
+/* program sis1 over the columns of a demand matrix, with one (s,S) policy per column */
+SEXP des_sis1_batch_C(SEXP demands, SEXP sR, SEXP SR, SEXP threadsR);
+
 #endif
@@ -10,6 +10,8 @@
 #include "des-2.h"
 
 #include "slist.h"
+#include "htable.h"
+#include "trans.h"
 
 
 /* --------------------------------------------------------------------------------
@@ -30,7 +32,7 @@ SEXP des_2_1_1_C(SEXP aR, SEXP mR){
       R_CheckUserInterrupt();
     }
     p += 1;
-    x = (a * x) % m; /* beware of a * x overflow */
+    x = (int)(((int64_t)a * x) % m); /* 64-bit product, a * x overflows int */
   }
 
   int res;
@@ -67,13 +69,12 @@ SEXP des_2_1_2_C(SEXP aR, SEXP mR){
       R_CheckUserInterrupt();
     }
 
-    SEXP gcd = gcd_C(Rf_ScalarInteger(i),Rf_ScalarInteger(m-1));
-    if(Rf_asInteger(gcd) == 1){
+    if(gcd(i,m-1) == 1){
       mults[mults_found] = x;
       mults_found++;
     }
     i++;
-    x = (a * x) % m; /* beware of a * x overflow */
+    x = (int)(((int64_t)a * x) % m); /* 64-bit product, a * x overflows int */
 
   }
 
@@ -104,7 +105,7 @@ SEXP des_2_2_1_C(SEXP xR, SEXP aR, SEXP mR){
   int t = a * (x % q) - r * (x / q); // t = gamma(x)
   free(factor);
 
-  if(t > 0){
+  if(t >= 0){
     return ScalarInteger(t); // delta(x) = 0
   } else {
     return ScalarInteger(t+m); // delta(x) = 1
@@ -114,14 +115,13 @@ SEXP des_2_2_1_C(SEXP xR, SEXP aR, SEXP mR){
 /* internal C version of 2.2.1 */
 int g(const int x, const int a, const int m){
 
-  int* factor = approx_factor(a,m);
-  int q = factor[0];
-  int r = factor[1];
+  /* approximate factorization m = aq + r, without allocating */
+  int q = m / a;
+  int r = m % a;
 
   int t = a * (x % q) - r * (x / q); // t = gamma(x)
-  free(factor);
 
-  if(t > 0){
+  if(t >= 0){
     return t; // delta(x) = 0
   } else {
     return t+m; // delta(x) = 1
@@ -129,6 +129,58 @@ int g(const int x, const int a, const int m){
 };
 
 
+/* 64-bit version: Schrage's decomposition if a is modulus-compatible, otherwise a 128-bit product */
+int64_t g64(const int64_t x, const int64_t a, const int64_t m){
+  int64_t q = m / a;
+  int64_t r = m % a;
+  if(r < q){
+    return pr_schrage64(x, a, q, r, m);
+  }
+  return (int64_t)pr_mul_mod64((uint64_t)x, (uint64_t)a, (uint64_t)m);
+};
+
+/* check 0 < a < m, for the 64-bit entry points */
+static void mult_args64(int64_t a, int64_t m){
+  if(m < 2){
+    Rf_error("'m' should be at least 2");
+  }
+  if(a <= 0 || a >= m){
+    Rf_error("'a' should be in 1,...,m-1");
+  }
+};
+
+SEXP des_2_2_1_64_C(SEXP xR, SEXP aR, SEXP mR){
+
+  int64_t a = as_int64(aR, "a");
+  int64_t m = as_int64(mR, "m");
+  mult_args64(a, m);
+
+  if(TYPEOF(xR) != REALSXP){
+    Rf_error("'x' should be a double or integer64");
+  }
+
+  R_xlen_t n = XLENGTH(xR);
+  SEXP output = PROTECT(alloc_int64(n, is_integer64(xR) || is_integer64(aR) || is_integer64(mR)));
+
+  int64_t q = m / a;
+  int64_t r = m % a;
+
+  for(R_xlen_t i=0; i<n; i++){
+    int64_t x = get_int64(xR, i);
+    if(x == INT64_NA || x < 0 || x >= m){
+      set_int64(output, i, INT64_NA);
+    } else if(r < q){
+      set_int64(output, i, pr_schrage64(x, a, q, r, m));
+    } else {
+      set_int64(output, i, (int64_t)pr_mul_mod64((uint64_t)x, (uint64_t)a, (uint64_t)m));
+    }
+  }
+
+  UNPROTECT(1);
+  return output;
+};
+
+
 /* --------------------------------------------------------------------------------
 #   algorithm 2.2.2: Given the prime modulus m and any associated full-period, modulus- compatible multiplier a the following algorithm generates all the full-period, modulus- compatible multipliers relative to m.
 -------------------------------------------------------------------------------- */
@@ -155,8 +207,9 @@ SEXP des_2_2_2_C(SEXP aR, SEXP mR){
 
     if((m % x < m / x) && (gcd(i,m-1) == 1)){
       /* x is a full-period modulus-compatible multiplier */
-      if(mults_i > mults_sz){
-        mults_found = (int*)realloc(mults_found,mults_sz*2*sizeof(int));
+      if(mults_i >= mults_sz){
+        mults_sz *= 2;
+        mults_found = (int*)realloc(mults_found,mults_sz*sizeof(int));
       }
       mults_found[mults_i] = x;
       mults_i++;
@@ -176,45 +229,232 @@ SEXP des_2_2_2_C(SEXP aR, SEXP mR){
 
 
 /* --------------------------------------------------------------------------------
-#   algorithm 2.5.1 (+time,-space) Given the state transition function g(·) and initial state x0, this algorithm determines the fundamental pair (s, p)
+#   algorithms 2.1.1, 2.1.2 and 2.2.2 without walking the period: with the prime factors q of m-1,
+#   a is full-period iff a^((m-1)/q) != 1 for all q, and the full-period multipliers are
+#   exactly a^i mod m for i relatively prime to m-1
 -------------------------------------------------------------------------------- */
 
-SEXP des_2_5_1_C(SEXP g, SEXP x0R, SEXP rho){
+SEXP des_2_1_1_factor_C(SEXP aR, SEXP mR){
+
+  int a = Rf_asInteger(aR);
+  int m = Rf_asInteger(mR);
 
-  if(!Rf_isFunction(g)){
-    Rf_error("'g' should be a function");
+  if(a == NA_INTEGER || m == NA_INTEGER || !pr_is_prime(m)){
+    return Rf_ScalarLogical(0);
   }
-  if(!Rf_isEnvironment(rho)){
-    Rf_error("'rho' should be an environment");
+
+  int q[PR_MAX_FACTORS];
+  int nq = pr_factor(m - 1, q);
+
+  return Rf_ScalarLogical(pr_is_full_period(a, m, q, nq));
+};
+
+/* 64-bit version of 2.1.1 for prime moduli below 2^63 */
+SEXP des_2_1_1_64_C(SEXP aR, SEXP mR){
+
+  int64_t a = as_int64(aR, "a");
+  int64_t m = as_int64(mR, "m");
+
+  if(m < 2 || !pr_is_prime64((uint64_t)m)){
+    return Rf_ScalarLogical(0);
   }
 
-  int x0 = Rf_asInteger(x0R);
-  int t = 0;
-  int s = 0;
+  uint64_t q[PR_MAX_FACTORS];
+  int nq = pr_factor64((uint64_t)m - 1, q);
+
+  return Rf_ScalarLogical(a > 0 && pr_is_full_period64((uint64_t)a, (uint64_t)m, q, nq));
+};
 
+/* check the arguments of the enumerations and factor m-1 */
+static int full_period_args(int a, int m, int* q){
+  if(m == NA_INTEGER || m < 3 || !pr_is_prime(m)){
+    Rf_error("'m' should be a prime greater than 2");
+  }
+  int nq = pr_factor(m - 1, q);
+  if(a == NA_INTEGER || !pr_is_full_period(a, m, q, nq)){
+    Rf_error("'a' is not a full-period multiplier relative to 'm'");
+  }
+  return nq;
+};
+
+/* largest gap between consecutive i relatively prime to m-1 taken from a table of powers of a */
+#define PR_GAP 64
+
+/* exponents sieved at once */
+#define PR_BLOCK (1 << 16)
+
+SEXP des_2_1_2_factor_C(SEXP aR, SEXP mR){
+
+  int a = Rf_asInteger(aR);
+  int m = Rf_asInteger(mR);
+
+  int q[PR_MAX_FACTORS];
+  int nq = full_period_args(a, m, q);
+
+  /* there are exactly totient(m-1) full-period multipliers */
+  int64_t phi = pr_totient(m - 1, q, nq);
+  SEXP output = PROTECT(Rf_allocVector(INTSXP, (R_xlen_t)phi));
+  int* mults = INTEGER(output);
+
+  /* apow[d] = a^d mod m */
+  int64_t apow[PR_GAP + 1];
+  apow[0] = 1;
+  for(int d=1; d<=PR_GAP; d++){
+    apow[d] = (apow[d-1] * a) % m;
+  }
+
+  /* sieve the exponents i = 1,...,m-2 in blocks, marking multiples of each prime factor of m-1 */
+  const int64_t B = PR_BLOCK;
+  unsigned char* mark = (unsigned char*)R_alloc(B, sizeof(unsigned char)); /* released by R, even on interrupt */
+
+  int64_t x = 1;      /* a^last */
+  int64_t last = 0;   /* last exponent relatively prime to m-1 */
+  int64_t found = 0;
+
+  for(int64_t lo=1; lo<m-1; lo+=B){
+
+    if(((lo / B) & 0xFF) == 0){
+      R_CheckUserInterrupt();
+    }
+
+    int64_t len = (m - 1 - lo < B) ? m - 1 - lo : B;
+    memset(mark, 0, len);
+    for(int j=0; j<nq; j++){
+      for(int64_t k=(q[j] - lo % q[j]) % q[j]; k<len; k+=q[j]){
+        mark[k] = 1;
+      }
+    }
+
+    for(int64_t k=0; k<len; k++){
+      if(!mark[k]){
+        int64_t gap = lo + k - last;
+        int64_t step = (gap <= PR_GAP) ? apow[gap] : pr_pow_mod(a, gap, m);
+        x = (x * step) % m;
+        last = lo + k;
+        mults[found++] = (int)x;
+      }
+    }
+  }
+  UNPROTECT(1);
+  return output;
+};
+
+SEXP des_2_2_2_factor_C(SEXP aR, SEXP mR){
+
+  int a = Rf_asInteger(aR);
+  int m = Rf_asInteger(mR);
+
+  int q[PR_MAX_FACTORS];
+  int nq = full_period_args(a, m, q);
+
+  if(m % a >= m / a){
+    Rf_error("'a' is not modulus-compatible relative to 'm'");
+  }
+
+  /* x is modulus-compatible iff m mod x < floor(m/x); that holds for every x <= sqrt(m), and for
+     larger x with floor(m/x) = k iff (m-k)/k < x <= m/k, so only about 2 sqrt(m) candidates need testing */
+  int s = (int)sqrt((double)m);
+  while((int64_t)(s + 1) * (s + 1) <= m){
+    s++;
+  }
+  while((int64_t)s * s > m){
+    s--;
+  }
 
-  /* R function call and its argument */
-  SEXP R_fcall, x;
-  PROTECT(R_fcall = lang2(g, R_NilValue));
-  PROTECT(x = allocVector(INTSXP,1));
+  int* mults = (int*)calloc(2 * (size_t)s + 2, sizeof(int));
+  int found = 0;
+
+  for(int x=1; x<=s; x++){
+    if(pr_is_full_period(x, m, q, nq)){
+      mults[found++] = x;
+    }
+  }
+
+  for(int k=m/(s+1); k>=1; k--){
+    int64_t lo = (int64_t)m / (k + 1) + 1;
+    int64_t lo2 = (int64_t)(m - k) / k + 1;
+    if(lo2 > lo){
+      lo = lo2;
+    }
+    if(lo < s + 1){
+      lo = s + 1;
+    }
+    int64_t hi = m / k;
+    if(hi > m - 1){
+      hi = m - 1;
+    }
+    for(int64_t x=lo; x<=hi; x++){
+      if((m % x < m / x) && pr_is_full_period((int)x, m, q, nq)){
+        mults[found++] = (int)x;
+      }
+    }
+  }
+
+  SEXP output = PROTECT(Rf_allocVector(INTSXP,found));
+  memcpy(INTEGER(output),mults,sizeof(int)*found);
+
+  free(mults);
+  UNPROTECT(1);
+  return output;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   fundamental pair (s, p) as a named vector
+-------------------------------------------------------------------------------- */
+
+static SEXP fundamental_pair(int s, int p){
+  SEXP out = PROTECT(Rf_allocVector(INTSXP,2));
+  INTEGER(out)[0] = s;
+  INTEGER(out)[1] = p;
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP,2));
+  Rf_namesgets(out, nms);
+  SET_STRING_ELT(nms, 0, Rf_mkChar("s"));
+  SET_STRING_ELT(nms, 1, Rf_mkChar("p"));
+  UNPROTECT(2);
+  return out;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   algorithm 2.5.1 (+time,-space) Given the state transition function g(·) and initial state x0, this algorithm determines the fundamental pair (s, p)
+-------------------------------------------------------------------------------- */
+
+SEXP des_2_5_1_C(SEXP g, SEXP x0R, SEXP rho){
+
+  /* state transition function (R closure or native) */
+  trans tr;
+  get_trans(&tr, g, rho);
+
+  int x0 = get_trans_x0(&tr, x0R);
+  int t = 0;
+  int s = 0;
 
   /* initialize the list x */
   int_slist x_lst;
   init_int_slist(&x_lst);
-  add_int_slist(&x_lst,x0);
+  if(!add_int_slist(&x_lst,x0)){
+    Rf_error("unable to allocate memory for the list of states");
+  }
 
   int x_tp1;
+  int64_t polls = 0;
 
   /* while no match found */
   while(s == t){
 
-    /* evaluate x_{t+1} = g(x_{t}) */
-    INTEGER(x)[0] = x_lst.tail->value;
-    SETCADR(R_fcall,x);
+    /* each step rescans the list, so count the states visited */
+    if(trans_poll_due(&tr, &polls, (int64_t)t + 1) && trans_interrupted()){
+      free_int_slist(&x_lst);
+      Rf_error("interrupted");
+    }
 
-    /* add a state to the list */
-    x_tp1 = Rf_asInteger(Rf_eval(R_fcall,rho));
-    add_int_slist(&x_lst,x_tp1);
+    /* evaluate x_{t+1} = g(x_{t}) and add a state to the list */
+    x_tp1 = trans_eval(&tr, x_lst.tail->value);
+    if(!add_int_slist(&x_lst,x_tp1)){
+      free_int_slist(&x_lst);
+      Rf_error("unable to allocate memory for the list of states (%d states)", t + 1);
+    }
     t++;
 
     /* traverse the list */
@@ -233,53 +473,89 @@ SEXP des_2_5_1_C(SEXP g, SEXP x0R, SEXP rho){
   /* period is the distance between matches */
   int p = t - s;
 
-  /* build SEXP objects to return to R */
-  SEXP out = PROTECT(Rf_allocVector(INTSXP,2));
-  INTEGER(out)[0] = s;
-  INTEGER(out)[1] = p;
-  SEXP nms = PROTECT(Rf_allocVector(STRSXP,2));
-  Rf_namesgets(out, nms);
-  SET_STRING_ELT(nms, 0, Rf_mkChar("s"));
-  SET_STRING_ELT(nms, 1, Rf_mkChar("p"));
-
   /* clean up after ourselves */
   free_int_slist(&x_lst);
-  UNPROTECT(4);
-  return out;
+  UNPROTECT(tr.nprotect);
+  return fundamental_pair(s, p);
 };
 
 
 /* --------------------------------------------------------------------------------
-#   algorithm 2.5.2 (high time, low space) Given the state transition function g(·) and initial state x0, this algorithm determines the fundamental pair (s, p)
+#   algorithm 2.5.1 with a hash table: each state is stored with the index t it was first seen at,
+#   so a repeat is detected in O(1) expected time instead of by rescanning the list of states
 -------------------------------------------------------------------------------- */
 
-SEXP des_2_5_2_C(SEXP g, SEXP x0R, SEXP rho){
+SEXP des_2_5_hash_C(SEXP g, SEXP x0R, SEXP rho){
+
+  /* state transition function (R closure or native) */
+  trans tr;
+  get_trans(&tr, g, rho);
+
+  int x0 = get_trans_x0(&tr, x0R);
+  int xt = x0;
+  int t = 0;
+  int s = -1;
 
-  if(!Rf_isFunction(g)){
-    Rf_error("'g' should be a function");
+  /* state -> first index it appeared at */
+  int_htable seen;
+  int64_t found = -1;
+  if(!init_int_htable(&seen, 1024)){
+    Rf_error("unable to allocate memory for the hash table");
   }
-  if(!Rf_isEnvironment(rho)){
-    Rf_error("'rho' should be an environment");
+  insert_int_htable(&seen, x0, 0, &found);
+
+  /* while no match found */
+  int64_t polls = 0;
+  while(found < 0){
+
+    if(trans_poll_due(&tr, &polls, 1) && trans_interrupted()){
+      free_int_htable(&seen);
+      Rf_error("interrupted");
+    }
+
+    /* evaluate x_{t+1} = g(x_{t}) */
+    xt = trans_eval(&tr, xt);
+    t++;
+
+    if(!insert_int_htable(&seen, xt, t, &found)){
+      free_int_htable(&seen);
+      Rf_error("unable to allocate memory for the hash table (%d states)", t);
+    }
   }
+  s = (int)found;
 
-  int x0 = Rf_asInteger(x0R);
+  /* period is the distance between matches */
+  int p = t - s;
+
+  /* clean up after ourselves */
+  free_int_htable(&seen);
+  UNPROTECT(tr.nprotect);
+  return fundamental_pair(s, p);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   algorithm 2.5.2 (high time, low space) Given the state transition function g(·) and initial state x0, this algorithm determines the fundamental pair (s, p)
+-------------------------------------------------------------------------------- */
+
+SEXP des_2_5_2_C(SEXP g, SEXP x0R, SEXP rho){
+
+  /* state transition function (R closure or native) */
+  trans tr;
+  get_trans(&tr, g, rho);
+
+  int x0 = get_trans_x0(&tr, x0R);
   int xt = x0;
   int xs;
 
   int t = 0;
   int s = 0;
-
-  /* R function call and its argument */
-  SEXP R_fcall, xarg;
-  PROTECT(R_fcall = lang2(g, R_NilValue));
-  PROTECT(xarg = allocVector(INTSXP,1));
+  int64_t polls = 0;
 
   while(t == s){
 
     /* evaluate x_{t} = g(x_{t}) */
-    INTEGER(xarg)[0] = xt;
-    SETCADR(R_fcall,xarg);
-    xt = Rf_asInteger(Rf_eval(R_fcall,rho));
+    xt = trans_eval(&tr, xt);
 
     t++;
     xs = x0;
@@ -288,11 +564,12 @@ SEXP des_2_5_2_C(SEXP g, SEXP x0R, SEXP rho){
     while(xs != xt){
 
       /* evaluate x_{s} = g(x_{s}) */
-      INTEGER(xarg)[0] = xs;
-      SETCADR(R_fcall,xarg);
-      xs = Rf_asInteger(Rf_eval(R_fcall,rho));
+      xs = trans_eval(&tr, xs);
 
       s++;
+      if(trans_poll_due(&tr, &polls, 1)){
+        R_CheckUserInterrupt();
+      }
 
     }
 
@@ -301,18 +578,9 @@ SEXP des_2_5_2_C(SEXP g, SEXP x0R, SEXP rho){
   /* period is the distance between matches */
   int p = t - s;
 
-  /* build SEXP objects to return to R */
-  SEXP out = PROTECT(Rf_allocVector(INTSXP,2));
-  INTEGER(out)[0] = s;
-  INTEGER(out)[1] = p;
-  SEXP nms = PROTECT(Rf_allocVector(STRSXP,2));
-  Rf_namesgets(out, nms);
-  SET_STRING_ELT(nms, 0, Rf_mkChar("s"));
-  SET_STRING_ELT(nms, 1, Rf_mkChar("p"));
-
   /* clean up after ourselves */
-  UNPROTECT(4);
-  return out;
+  UNPROTECT(tr.nprotect);
+  return fundamental_pair(s, p);
 };
 
 
@@ -322,49 +590,34 @@ SEXP des_2_5_2_C(SEXP g, SEXP x0R, SEXP rho){
 
 SEXP des_2_5_3_C(SEXP g, SEXP x0R, SEXP rho){
 
-  if(!Rf_isFunction(g)){
-    Rf_error("'g' should be a function");
-  }
-  if(!Rf_isEnvironment(rho)){
-    Rf_error("'rho' should be an environment");
-  }
+  /* state transition function (R closure or native) */
+  trans tr;
+  get_trans(&tr, g, rho);
 
   int xq, z, s, xs, p;
-  int x0 = Rf_asInteger(x0R);
+  int x0 = get_trans_x0(&tr, x0R);
   int q = 1;
-
-  /* R function call and its argument */
-  SEXP R_fcall, xarg;
-  PROTECT(R_fcall = lang2(g, R_NilValue));
-  PROTECT(xarg = allocVector(INTSXP,1));
-  int* xarg_p = INTEGER(xarg);
+  int64_t polls = 0;
 
   /* x.q = g(x.o); */
-  xarg_p[0] = x0;
-  SETCADR(R_fcall,xarg);
-  xq = Rf_asInteger(Rf_eval(R_fcall,rho));
+  xq = trans_eval(&tr, x0);
 
   /* z = g(x.q); */
-  xarg_p[0] = xq;
-  SETCADR(R_fcall,xarg);
-  z = Rf_asInteger(Rf_eval(R_fcall,rho));
+  z = trans_eval(&tr, xq);
 
   /* step 1: determine q and x.q */
   while(xq != z){
     q++;
 
     /* x.q = g(x.q) */
-    xarg_p[0] = xq;
-    SETCADR(R_fcall,xarg);
-    xq = Rf_asInteger(Rf_eval(R_fcall,rho));
+    xq = trans_eval(&tr, xq);
 
     /* z = g(g(z)) */
-    xarg_p[0] = z;
-    SETCADR(R_fcall,xarg);
-    int z1 = Rf_asInteger(Rf_eval(R_fcall,rho));
-    xarg_p[0] = z1;
-    SETCADR(R_fcall,xarg);
-    z = Rf_asInteger(Rf_eval(R_fcall,rho));
+    z = trans_eval(&tr, trans_eval(&tr, z));
+
+    if(trans_poll_due(&tr, &polls, 3)){
+      R_CheckUserInterrupt();
+    }
   }
 
   s = 0;
@@ -376,52 +629,378 @@ SEXP des_2_5_3_C(SEXP g, SEXP x0R, SEXP rho){
     s++;
 
     /* x.s = g(x.s) */
-    xarg_p[0] = xs;
-    SETCADR(R_fcall,xarg);
-    xs = Rf_asInteger(Rf_eval(R_fcall,rho));
+    xs = trans_eval(&tr, xs);
 
     /* z = g(z) */
-    xarg_p[0] = z;
-    SETCADR(R_fcall,xarg);
-    z = Rf_asInteger(Rf_eval(R_fcall,rho));
+    z = trans_eval(&tr, z);
 
+    if(trans_poll_due(&tr, &polls, 2)){
+      R_CheckUserInterrupt();
+    }
   }
 
   /* step 3: determine p */
-  if(2 * s <= q){
+  if(2 * (int64_t)s <= q){
     p = q;
   } else {
     p = 1;
 
     /* z = g(x.s) */
-    xarg_p[0] = xs;
-    SETCADR(R_fcall,xarg);
-    z = Rf_asInteger(Rf_eval(R_fcall,rho));
+    z = trans_eval(&tr, xs);
 
     while(xs != z){
       p++;
 
       /* z = g(z) */
-      xarg_p[0] = z;
-      SETCADR(R_fcall,xarg);
-      z = Rf_asInteger(Rf_eval(R_fcall,rho));
+      z = trans_eval(&tr, z);
+
+      if(trans_poll_due(&tr, &polls, 1)){
+        R_CheckUserInterrupt();
+      }
     }
   }
 
-  /* build SEXP objects to return to R */
-  SEXP out = PROTECT(Rf_allocVector(INTSXP,2));
-  INTEGER(out)[0] = s;
-  INTEGER(out)[1] = p;
-  SEXP nms = PROTECT(Rf_allocVector(STRSXP,2));
-  Rf_namesgets(out, nms);
-  SET_STRING_ELT(nms, 0, Rf_mkChar("s"));
-  SET_STRING_ELT(nms, 1, Rf_mkChar("p"));
-
   /* clean up after ourselves */
-  UNPROTECT(4);
-  return out;
+  UNPROTECT(tr.nprotect);
+  return fundamental_pair(s, p);
+};
+
+
+
+/* --------------------------------------------------------------------------------
+#   common step for the Brent and distinguished point methods: given the period p and an index u <= s
+#   with state x.u, walk x.u and x.{u+p} forward together until they meet, at index s
+-------------------------------------------------------------------------------- */
+
+static int64_t find_s(const trans* tr, int64_t u, int xu, int64_t p){
+
+  int a = xu;
+  int b;
+  int64_t polls = 0;
+  if(trans_can_jump(tr)){
+    b = trans_jump(tr, xu, (uint64_t)p);
+  } else {
+    b = xu;
+    for(int64_t i=0; i<p; i++){
+      b = trans_eval(tr, b);
+      if(trans_poll_due(tr, &polls, 1)){
+        R_CheckUserInterrupt();
+      }
+    }
+  }
+
+  int64_t s = u;
+  while(a != b){
+    a = trans_eval(tr, a);
+    b = trans_eval(tr, b);
+    s++;
+    if(trans_poll_due(tr, &polls, 2)){
+      R_CheckUserInterrupt();
+    }
+  }
+  return s;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   Brent's cycle detection: the tortoise waits at x_{2^k - 1} while the hare runs ahead up to 2^k steps,
+#   so only one evaluation of g is needed per step of the hare
+-------------------------------------------------------------------------------- */
+
+static void brent_pair(const trans* tr, int x0, int64_t* s, int64_t* p){
+
+  int64_t power = 1;
+  int64_t lam = 1;
+  int tortoise = x0;
+  int hare = trans_eval(tr, x0);
+  int64_t polls = 0;
+
+  /* step 1: determine the period lam */
+  while(tortoise != hare){
+    if(power == lam){
+      tortoise = hare;
+      power *= 2;
+      lam = 0;
+    }
+    hare = trans_eval(tr, hare);
+    lam++;
+    if(trans_poll_due(tr, &polls, 1)){
+      R_CheckUserInterrupt();
+    }
+  }
+
+  /* step 2: determine s */
+  *p = lam;
+  *s = find_s(tr, 0, x0, lam);
+};
+
+SEXP des_2_5_brent_C(SEXP g, SEXP x0R, SEXP rho){
+
+  /* state transition function (R closure or native) */
+  trans tr;
+  get_trans(&tr, g, rho);
+
+  int x0 = get_trans_x0(&tr, x0R);
+  int64_t s, p;
+  brent_pair(&tr, x0, &s, &p);
+
+  UNPROTECT(tr.nprotect);
+  return fundamental_pair((int)s, (int)p);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   distinguished point method: only states whose low bits are zero (and x0) are stored, with the index they
+#   were first seen at; the first distinguished state to repeat is the first one on the cycle, so the
+#   distance between its two visits is p. Every stored index before it is before the cycle, so the largest
+#   of them is a lower bound u for s. A Brent tortoise runs alongside, so the walk also ends if no state on
+#   the cycle is distinguished.
+-------------------------------------------------------------------------------- */
+
+/* largest stored index below t0 (and its state); 0 and x0 if there is none */
+static int64_t dp_base(const int_htable* table, int64_t t0, int x0, int* xu){
+  int64_t u = 0;
+  *xu = x0;
+  for(size_t i=0; i<table->capacity; i++){
+    if(table->used[i] && table->value[i] < t0 && table->value[i] > u){
+      u = table->value[i];
+      *xu = table->key[i];
+    }
+  }
+  return u;
+};
+
+/* returns 1 on success, 0 if out of memory */
+static int dp_serial(const trans* tr, int x0, int bits, int64_t* s, int64_t* p){
+
+  const int mask = (int)((1U << bits) - 1U);
+
+  int_htable table;
+  if(!init_int_htable(&table, 1024)){
+    return 0;
+  }
+  int64_t found;
+  insert_int_htable(&table, x0, 0, &found);
+
+  int64_t power = 1;
+  int64_t lam = 0;
+  int tortoise = x0;
+
+  int x = x0;
+  int64_t t = 0;
+  int64_t t0 = -1;
+  int64_t polls = 0;
+
+  for(;;){
+    if(trans_poll_due(tr, &polls, 1) && trans_interrupted()){
+      free_int_htable(&table);
+      Rf_error("interrupted");
+    }
+    x = trans_eval(tr, x);
+    t++;
+    lam++;
+
+    if((x & mask) == 0 || x == x0){
+      if(!insert_int_htable(&table, x, t, &t0)){
+        free_int_htable(&table);
+        return 0;
+      }
+      if(t0 >= 0){
+        *p = t - t0;
+        break;
+      }
+    }
+    if(x == tortoise){
+      *p = lam;
+      break;
+    }
+    if(lam == power){
+      tortoise = x;
+      power *= 2;
+      lam = 0;
+    }
+  }
+
+  int xu = x0;
+  int64_t u = (t0 >= 0) ? dp_base(&table, t0, x0, &xu) : 0;
+  free_int_htable(&table);
+
+  *s = find_s(tr, u, xu, *p);
+  return 1;
+};
+
+/* distinguished states found by one thread in one segment of the walk */
+typedef struct dp_buf {
+  int*     x;
+  int64_t* t;
+  size_t   n;
+  size_t   capacity;
+  int      oom;  /* set if the buffer could not grow */
+} dp_buf;
+
+/* called inside the parallel region, so a failure is only recorded; the old arrays are kept until both grow */
+static void dp_push(dp_buf* buf, int x, int64_t t){
+  if(buf->oom){
+    return;
+  }
+  if(buf->n == buf->capacity){
+    size_t capacity = (buf->capacity == 0) ? 1024 : 2 * buf->capacity;
+    int* bx = (int*)realloc(buf->x, capacity * sizeof(int));
+    if(bx == NULL){
+      buf->oom = 1;
+      return;
+    }
+    buf->x = bx;
+    int64_t* bt = (int64_t*)realloc(buf->t, capacity * sizeof(int64_t));
+    if(bt == NULL){
+      buf->oom = 1;
+      return;
+    }
+    buf->t = bt;
+    buf->capacity = capacity;
+  }
+  buf->x[buf->n] = x;
+  buf->t[buf->n] = t;
+  buf->n++;
 };
 
+static void dp_free(dp_buf* buf, int threads, int_htable* table){
+  for(int j=0; j<threads; j++){
+    free(buf[j].x);
+    free(buf[j].t);
+  }
+  free(buf);
+  free_int_htable(table);
+};
+
+/* each round, thread j jumps to index done + j*seg and walks one segment of at most DP_SEGMENT states; the segments are then
+   merged in index order, so the result does not depend on the number of threads */
+#define DP_SEGMENT (1 << 20)
+
+/* returns 1 on success, 0 if out of memory */
+static int dp_parallel(const trans* tr, int x0, int bits, int threads, int64_t* s, int64_t* p){
+
+  const int mask = (int)((1U << bits) - 1U);
+
+  int_htable table;
+  if(!init_int_htable(&table, 1024)){
+    return 0;
+  }
+  int64_t found;
+  insert_int_htable(&table, x0, 0, &found);
+
+  dp_buf* buf = (dp_buf*)calloc(threads, sizeof(dp_buf));
+  if(buf == NULL){
+    free_int_htable(&table);
+    return 0;
+  }
+
+  /* no need for segments longer than the whole state space divided among the threads */
+  int64_t seg = ((int64_t)tr->m + threads - 1) / threads;
+  if(seg > DP_SEGMENT){
+    seg = DP_SEGMENT;
+  }
+
+  int64_t done = 0;
+  int64_t t0 = -1;
+
+  while(t0 < 0){
+
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(threads) schedule(static, 1)
+#endif
+    for(int j=0; j<threads; j++){
+      int64_t start = done + (int64_t)j * seg;
+      int x = trans_jump(tr, x0, (uint64_t)start);
+      buf[j].n = 0;
+      for(int64_t t=start+1; t<=start+seg; t++){
+        x = trans_eval(tr, x);
+        if((x & mask) == 0 || x == x0){
+          dp_push(&buf[j], x, t);
+        }
+      }
+    }
+
+    for(int j=0; j<threads; j++){
+      if(buf[j].oom){
+        dp_free(buf, threads, &table);
+        return 0;
+      }
+    }
+    if(trans_interrupted()){
+      dp_free(buf, threads, &table);
+      Rf_error("interrupted");
+    }
+
+    /* merge in index order; the first repeat is the first distinguished state on the cycle */
+    for(int j=0; j<threads && t0 < 0; j++){
+      for(size_t i=0; i<buf[j].n; i++){
+        if(!insert_int_htable(&table, buf[j].x[i], buf[j].t[i], &t0)){
+          dp_free(buf, threads, &table);
+          return 0;
+        }
+        if(t0 >= 0){
+          *p = buf[j].t[i] - t0;
+          break;
+        }
+      }
+    }
+
+    done += (int64_t)threads * seg;
+
+    /* give up after about m states and fall back to Brent's method, which is exact; a distinguished
+       state on the cycle may still be ahead (its repeat can come as late as s + 2p - 1 < 2m) */
+    if(t0 < 0 && done > (int64_t)tr->m + seg){
+      break;
+    }
+  }
+
+  if(t0 < 0){
+    dp_free(buf, threads, &table);
+    brent_pair(tr, x0, s, p);
+    return 1;
+  }
+
+  int xu = x0;
+  int64_t u = dp_base(&table, t0, x0, &xu);
+  dp_free(buf, threads, &table);
+
+  *s = find_s(tr, u, xu, *p);
+  return 1;
+};
+
+SEXP des_2_5_dp_C(SEXP g, SEXP x0R, SEXP bitsR, SEXP threadsR, SEXP rho){
+
+  int bits = Rf_asInteger(bitsR);
+  int threads = Rf_asInteger(threadsR);
+  if(bits == NA_INTEGER || bits < 0 || bits > 30){
+    Rf_error("'bits' should be an integer in 0,...,30");
+  }
+  if(threads == NA_INTEGER || threads < 1){
+    Rf_error("'threads' should be a positive integer");
+  }
+
+  /* state transition function (R closure or native) */
+  trans tr;
+  get_trans(&tr, g, rho);
+
+  int x0 = get_trans_x0(&tr, x0R);
+  int64_t s, p;
+
+  /* walking from several points at once needs jump-ahead and a g that does not call R */
+  int ok;
+  if(threads > 1 && trans_can_jump(&tr)){
+    ok = dp_parallel(&tr, x0, bits, threads, &s, &p);
+  } else {
+    ok = dp_serial(&tr, x0, bits, &s, &p);
+  }
+  if(!ok){
+    Rf_error("unable to allocate memory for the distinguished states");
+  }
+
+  UNPROTECT(tr.nprotect);
+  return fundamental_pair((int)s, (int)p);
+};
 
 
 /* --------------------------------------------------------------------------------
@@ -435,15 +1014,24 @@ void free_lrng_C(SEXP ptr){
   R_ClearExternalPtr(ptr);
 };
 
-SEXP make_lrng_C(){
+SEXP make_lrng_C(SEXP seedR, SEXP streamR){
+
+  double seed = Rf_asReal(seedR);
+  int stream = Rf_asInteger(streamR);
+  if(ISNAN(seed) || seed < 1. || seed >= (double)RNG_MODULUS || seed != floor(seed)){
+    Rf_error("'seed' should be an integer in 1,...,2147483646");
+  }
+  if(stream == NA_INTEGER || stream < 0 || stream >= RNG_STREAMS){
+    Rf_error("'stream' should be an integer in 0,...,%d", RNG_STREAMS - 1);
+  }
 
   /* allocate the prng state */
   lrng* lrng_ptr = malloc(sizeof(struct lrng));
-  lrng_ptr->A = 48271;
-  lrng_ptr->M = 2147483647;
+  lrng_ptr->A = RNG_MULTIPLIER;
+  lrng_ptr->M = RNG_MODULUS;
   lrng_ptr->Q = lrng_ptr->M / lrng_ptr->A;
   lrng_ptr->R = lrng_ptr->M % lrng_ptr->A;
-  lrng_ptr->state = 1;
+  lrng_ptr->state = rng_skip((long)seed, (uint64_t)stream * RNG_JUMP);
   lrng_ptr->t = 1;
 
   /* return to R with function to free the memory when ptr goes out of scope */
@@ -463,3 +1051,47 @@ SEXP random_lrng_C(SEXP ptr){
   }
   return Rf_ScalarReal(((double) lrng_ptr->state / lrng_ptr->M));
 };
+
+SEXP random_n_lrng_C(SEXP ptr, SEXP nR, SEXP outR){
+  lrng* lrng_ptr = (lrng*)R_ExternalPtrAddr(ptr);
+  SEXP out = PROTECT(bulk_output(nR, outR, REALSXP));
+  double* out_ptr = REAL(out);
+  R_xlen_t n = XLENGTH(out);
+
+  /* the book's generator: use the fastest engine (same sequence as the Schrage loop below) */
+  if(lrng_ptr->A == RNG_MULTIPLIER && lrng_ptr->M == RNG_MODULUS){
+    rng_fill_engine(RNG_ENGINE_AUTO, &lrng_ptr->state, out_ptr, (size_t)n);
+    lrng_ptr->t = lrng_ptr->state;
+    UNPROTECT(1);
+    return out;
+  }
+
+  /* keep the generator in registers for the whole loop; same arithmetic as random_lrng_C */
+  const long A = lrng_ptr->A;
+  const long M = lrng_ptr->M;
+  const long Q = lrng_ptr->Q;
+  const long R = lrng_ptr->R;
+  long state = lrng_ptr->state;
+  long t = lrng_ptr->t;
+
+  for(R_xlen_t i=0; i<n; i++){
+    t = A * (state % Q) - R * (state / Q);
+    state = (t > 0) ? t : t + M;
+    out_ptr[i] = (double) state / M;
+  }
+
+  lrng_ptr->state = state;
+  lrng_ptr->t = t;
+  UNPROTECT(1);
+  return out;
+};
+
+SEXP skip_lrng_C(SEXP ptr, SEXP kR){
+  lrng* lrng_ptr = (lrng*)R_ExternalPtrAddr(ptr);
+  double k = Rf_asReal(kR);
+  if(ISNAN(k) || k < 0. || k != floor(k) || k > 9007199254740992.){
+    Rf_error("'k' should be a non-negative integer (at most 2^53)");
+  }
+  lrng_ptr->state = rng_skip(lrng_ptr->state, (uint64_t)k);
+  return R_NilValue;
+};
@@ -20,6 +20,9 @@
 #include <R_ext/Utils.h> // for user interrupt checking
 
 #include "des-errata.h" // for gcd
+#include "primroot.h" // for full-period tests by factoring m-1
+#include "rng.h" // for jump-ahead
+#include "bulk.h"
 
 
 /* --------------------------------------------------------------------------------
@@ -38,15 +41,39 @@ SEXP des_2_2_1_C(SEXP xR, SEXP aR, SEXP mR);
 /* internal C version of 2.2.1 */
 int g(const int x, const int a, const int m);
 
+/* 64-bit versions of 2.2.1 (vectorized over x; double or integer64 in and out) */
+SEXP des_2_2_1_64_C(SEXP xR, SEXP aR, SEXP mR);
+
+int64_t g64(const int64_t x, const int64_t a, const int64_t m);
+
 /* algorithm 2.2.2: Given the prime modulus m and any associated full-period, modulus- compatible multiplier a the following algorithm generates all the full-period, modulus- compatible multipliers relative to m. */
 SEXP des_2_2_2_C(SEXP aR, SEXP mR);
 
+/* algorithms 2.1.1, 2.1.2 and 2.2.2 using the prime factors of m-1 instead of walking the period */
+SEXP des_2_1_1_factor_C(SEXP aR, SEXP mR);
+
+SEXP des_2_1_2_factor_C(SEXP aR, SEXP mR);
+
+SEXP des_2_2_2_factor_C(SEXP aR, SEXP mR);
+
+/* 64-bit version of 2.1.1 (Miller-Rabin and Pollard's rho to factor m-1) */
+SEXP des_2_1_1_64_C(SEXP aR, SEXP mR);
+
 /* algorithm 2.5.1 (low time, high space) Given the state transition function g(·) and initial state x0, this algorithm determines the fundamental pair (s, p)  */
 SEXP des_2_5_1_C(SEXP g, SEXP x0R, SEXP rho);
 
 /* algorithm 2.5.2 (high time, low space) Given the state transition function g(·) and initial state x0, this algorithm determines the fundamental pair (s, p)  */
 SEXP des_2_5_2_C(SEXP g, SEXP x0R, SEXP rho);
 
+/* algorithm 2.5.1 with a hash table (low time, high space): find the fundamental pair (s, p) in O(s+p) expected time */
+SEXP des_2_5_hash_C(SEXP g, SEXP x0R, SEXP rho);
+
+/* Brent's cycle detection (low time, low space): same result as 2.5.3 with fewer evaluations of g */
+SEXP des_2_5_brent_C(SEXP g, SEXP x0R, SEXP rho);
+
+/* distinguished point cycle detection, walking the chain on several threads for Lehmer and LCG transitions */
+SEXP des_2_5_dp_C(SEXP g, SEXP x0R, SEXP bitsR, SEXP threadsR, SEXP rho);
+
 /* algorithm 2.5.3 (best overall) Given the state transition function g(·) and initial state x0, this algorithm determines the fundamental pair (s, p)  */
 SEXP des_2_5_3_C(SEXP g, SEXP x0R, SEXP rho);
 
@@ -67,8 +94,15 @@ typedef struct lrng {
 
 void free_lrng_C(SEXP ptr);
 
-SEXP make_lrng_C();
+/* seeded with stream j of PlantSeeds(seed): seed jumped ahead by j * RNG_JUMP states */
+SEXP make_lrng_C(SEXP seedR, SEXP streamR);
 
 SEXP random_lrng_C(SEXP ptr);
 
+/* fill out (if not NULL) or a new vector of length n with uniform(0,1) variates */
+SEXP random_n_lrng_C(SEXP ptr, SEXP nR, SEXP outR);
+
+/* advance the state by k draws in O(log k) */
+SEXP skip_lrng_C(SEXP ptr, SEXP kR);
+
 #endif
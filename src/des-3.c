@@ -0,0 +1,724 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Algorithms from Ch. 3
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "des-3.h"
+#include "des-8.h" // for output statistics via external ptr
+#include "sis.h"   // for the (s,S) grid search
+
+#include <limits.h>
+
+
+/* --------------------------------------------------------------------------------
+#   library rngs: multi-stream Lehmer random number generator via external ptr
+-------------------------------------------------------------------------------- */
+
+rngs* get_rngs(SEXP ptr){
+  if(TYPEOF(ptr) != EXTPTRSXP){
+    Rf_error("'ptr' should be an external pointer made by 'make_rngs'");
+  }
+  rngs* rngs_ptr = (rngs*)R_ExternalPtrAddr(ptr);
+  if(rngs_ptr == NULL){
+    Rf_error("'ptr' points to a generator that has already been freed");
+  }
+  return rngs_ptr;
+};
+
+/* seeds must be states of the generator, 1,...,m-1 */
+static long check_seed(SEXP seedR){
+  double x = Rf_asReal(seedR);
+  if(ISNAN(x) || x < 1. || x >= (double)RNG_MODULUS || x != floor(x)){
+    Rf_error("'seed' should be an integer in 1,...,2147483646");
+  }
+  return (long)x;
+};
+
+/* code to free the memory when the pointer is garbage collected by R */
+void free_rngs_C(SEXP ptr){
+  rngs* rngs_ptr = (rngs*)R_ExternalPtrAddr(ptr);
+  free(rngs_ptr);
+  R_ClearExternalPtr(ptr);
+};
+
+SEXP make_rngs_C(SEXP seedR){
+
+  long seed = check_seed(seedR);
+
+  /* allocate the prng state */
+  rngs* rngs_ptr = malloc(sizeof(struct rngs));
+  if(rngs_ptr == NULL){
+    Rf_error("unable to allocate memory for the generator");
+  }
+  rngs_plant_seeds(rngs_ptr, seed);
+  rngs_ptr->stream = 0;
+
+  /* return to R with function to free the memory when ptr goes out of scope */
+  SEXP ptr = PROTECT(R_MakeExternalPtr(rngs_ptr, R_NilValue, R_NilValue));
+  R_RegisterCFinalizerEx(ptr,free_rngs_C,TRUE);
+  UNPROTECT(1);
+  return ptr;
+};
+
+SEXP plant_seeds_rngs_C(SEXP ptr, SEXP seedR){
+  rngs* rngs_ptr = get_rngs(ptr);
+  rngs_plant_seeds(rngs_ptr, check_seed(seedR));
+  return R_NilValue;
+};
+
+SEXP select_stream_rngs_C(SEXP ptr, SEXP streamR){
+  rngs* rngs_ptr = get_rngs(ptr);
+  int stream = Rf_asInteger(streamR);
+  if(stream == NA_INTEGER || stream < 0 || stream >= RNG_STREAMS){
+    Rf_error("'stream' should be an integer in 0,...,%d", RNG_STREAMS - 1);
+  }
+  rngs_select_stream(rngs_ptr, stream);
+  return R_NilValue;
+};
+
+SEXP get_seed_rngs_C(SEXP ptr){
+  rngs* rngs_ptr = get_rngs(ptr);
+  return Rf_ScalarInteger((int)rngs_get_seed(rngs_ptr));
+};
+
+SEXP put_seed_rngs_C(SEXP ptr, SEXP seedR){
+  rngs* rngs_ptr = get_rngs(ptr);
+  rngs_put_seed(rngs_ptr, check_seed(seedR));
+  return R_NilValue;
+};
+
+SEXP skip_rngs_C(SEXP ptr, SEXP kR){
+  rngs* rngs_ptr = get_rngs(ptr);
+  double k = Rf_asReal(kR);
+  if(ISNAN(k) || k < 0. || k != floor(k) || k > 9007199254740992.){
+    Rf_error("'k' should be a non-negative integer (at most 2^53)");
+  }
+  rngs_skip(rngs_ptr, (uint64_t)k);
+  return R_NilValue;
+};
+
+SEXP random_rngs_C(SEXP ptr){
+  rngs* rngs_ptr = get_rngs(ptr);
+  return Rf_ScalarReal(rngs_random(rngs_ptr));
+};
+
+
+/* --------------------------------------------------------------------------------
+#   bulk variate generation from the current stream
+-------------------------------------------------------------------------------- */
+
+SEXP random_n_rngs_C(SEXP ptr, SEXP nR, SEXP outR, SEXP engineR){
+  rngs* rngs_ptr = get_rngs(ptr);
+  int engine = Rf_asInteger(engineR);
+  if(!rng_engine_available(engine)){
+    Rf_error("the requested engine is not available on this machine");
+  }
+  SEXP out = PROTECT(bulk_output(nR, outR, REALSXP));
+  rng_fill_engine(engine, &rngs_ptr->seed[rngs_ptr->stream], REAL(out), (size_t)XLENGTH(out));
+  UNPROTECT(1);
+  return out;
+};
+
+SEXP uniform_rngs_C(SEXP ptr, SEXP nR, SEXP aR, SEXP bR, SEXP outR){
+  rngs* rngs_ptr = get_rngs(ptr);
+  double a = Rf_asReal(aR);
+  double b = Rf_asReal(bR);
+  if(!(a < b)){
+    Rf_error("please set a < b");
+  }
+  SEXP out = PROTECT(bulk_output(nR, outR, REALSXP));
+  rngs_fill_uniform(rngs_ptr, a, b, REAL(out), (size_t)XLENGTH(out));
+  UNPROTECT(1);
+  return out;
+};
+
+SEXP equilikely_rngs_C(SEXP ptr, SEXP nR, SEXP aR, SEXP bR, SEXP outR){
+  rngs* rngs_ptr = get_rngs(ptr);
+  int a = Rf_asInteger(aR);
+  int b = Rf_asInteger(bR);
+  if(a == NA_INTEGER || b == NA_INTEGER || a > b){
+    Rf_error("please set a <= b");
+  }
+  SEXP out = PROTECT(bulk_output(nR, outR, INTSXP));
+  rngs_fill_equilikely(rngs_ptr, a, b, INTEGER(out), (size_t)XLENGTH(out));
+  UNPROTECT(1);
+  return out;
+};
+
+SEXP exponential_rngs_C(SEXP ptr, SEXP nR, SEXP muR, SEXP outR){
+  rngs* rngs_ptr = get_rngs(ptr);
+  double mu = Rf_asReal(muR);
+  if(ISNAN(mu) || mu <= 0.){
+    Rf_error("'mu' should be positive");
+  }
+  SEXP out = PROTECT(bulk_output(nR, outR, REALSXP));
+  rngs_fill_exponential(rngs_ptr, mu, REAL(out), (size_t)XLENGTH(out));
+  UNPROTECT(1);
+  return out;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   program ssq2: a single-server FIFO service node with generated arrival and service times
+-------------------------------------------------------------------------------- */
+
+const char* ssq_stat_names[SSQ_NSTAT] = {"n", "r", "w", "d", "s", "l", "q", "x"};
+
+void get_ssq_model(ssq_model* model, SEXP arrivalR, SEXP serviceR){
+  if(Rf_length(serviceR) != 2){
+    Rf_error("'service' should give the bounds of the Uniform service time distribution");
+  }
+  model->arrival = Rf_asReal(arrivalR);
+  model->service_a = REAL(serviceR)[0];
+  model->service_b = REAL(serviceR)[1];
+  if(ISNAN(model->arrival) || model->arrival <= 0.){
+    Rf_error("'arrival' (mean interarrival time) should be positive");
+  }
+  if(ISNAN(model->service_a) || ISNAN(model->service_b) || model->service_a < 0. || model->service_a >= model->service_b){
+    Rf_error("'service' should satisfy 0 <= service[1] < service[2]");
+  }
+};
+
+SEXP ssq_output(const double* stats){
+  SEXP out = PROTECT(Rf_allocVector(REALSXP, SSQ_NSTAT));
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP, SSQ_NSTAT));
+  for(int i=0; i<SSQ_NSTAT; i++){
+    REAL(out)[i] = stats[i];
+    SET_STRING_ELT(nms, i, Rf_mkChar(ssq_stat_names[i]));
+  }
+  Rf_namesgets(out, nms);
+  UNPROTECT(2);
+  return out;
+};
+
+void ssq2_run(const ssq_model* model, int64_t jobs, rngs* r, outstat* mon, double* out){
+
+  double arrival = 0.;   /* arrival time of job i */
+  double delay;          /* delay in queue */
+  double service;        /* service time */
+  double wait;           /* delay + service */
+  double departure = 0.; /* departure time of job i-1, then i */
+
+  struct {               /* sum of ...      */
+    double delay;        /*   delay times   */
+    double wait;         /*   wait times    */
+    double service;      /*   service times */
+  } sum = {0.0, 0.0, 0.0};
+
+  int stream = r->stream; /* restored on exit */
+
+  for(int64_t i=0; i<jobs; i++){
+
+    rngs_select_stream(r, 0);
+    arrival += rngs_exponential(r, model->arrival);
+
+    if(arrival < departure){
+      delay = departure - arrival;
+    } else {
+      delay = 0.;
+    }
+
+    rngs_select_stream(r, 1);
+    service = rngs_uniform(r, model->service_a, model->service_b);
+    wait = delay + service;
+    departure = arrival + wait;
+
+    sum.delay += delay;
+    sum.wait += wait;
+    sum.service += service;
+
+    if(mon != NULL){
+      outstat_update(mon, wait);
+    }
+  }
+
+  r->stream = stream;
+
+  double n = (double)jobs;
+  out[0] = n;
+  out[1] = arrival / n;             /* interarrival time */
+  out[2] = sum.wait / n;            /* wait              */
+  out[3] = sum.delay / n;           /* delay             */
+  out[4] = sum.service / n;         /* service time      */
+  out[5] = sum.wait / departure;    /* # in the node     */
+  out[6] = sum.delay / departure;   /* # in the queue    */
+  out[7] = sum.service / departure; /* utilization       */
+};
+
+SEXP des_ssq2_C(SEXP jobsR, SEXP arrivalR, SEXP serviceR, SEXP rngR, SEXP monitorR){
+
+  double jobs = Rf_asReal(jobsR);
+  if(ISNAN(jobs) || jobs < 1. || jobs != floor(jobs) || jobs > 9007199254740992.){
+    Rf_error("'jobs' should be a positive integer");
+  }
+
+  ssq_model model;
+  get_ssq_model(&model, arrivalR, serviceR);
+  rngs* r = get_rngs(rngR);
+
+  double stats[SSQ_NSTAT];
+  outstat* mon = Rf_isNull(monitorR) ? NULL : get_outstat(monitorR);
+
+  ssq2_run(&model, (int64_t)jobs, r, mon, stats);
+
+  return ssq_output(stats);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   program sis2: a simple (s,S) inventory system with generated demand and random delivery lag
+#   the inventory position (level plus outstanding orders) is reviewed at the start of each
+#   interval; demand is spread evenly over the interval and orders are delivered lag time units
+#   after they are placed. Only orders in transit are stored, so memory does not grow with the
+#   number of intervals
+-------------------------------------------------------------------------------- */
+
+const char* sis_stat_names[SIS_NSTAT] = {"setup", "holding", "shortage", "order", "demand"};
+
+void get_sis_demand(sis_model* model, SEXP demandR, SEXP parR){
+
+  model->demand = Rf_asInteger(demandR);
+  int npar = Rf_length(parR);
+  double* par = REAL(parR);
+  switch(model->demand){
+    case SIS_EQUILIKELY:
+      if(npar != 2 || ISNAN(par[0]) || ISNAN(par[1]) || par[0] < 0. || par[0] > par[1] || par[0] != floor(par[0]) || par[1] != floor(par[1]) || par[1] > 1e9){
+        Rf_error("Equilikely demand should give integers 0 <= a <= b");
+      }
+      break;
+    case SIS_POISSON:
+      if(npar != 1 || ISNAN(par[0]) || par[0] <= 0. || par[0] > RNG_POISSON_MAX){
+        Rf_error("Poisson demand should give a mean in (0, %g]", RNG_POISSON_MAX);
+      }
+      break;
+    case SIS_GEOMETRIC:
+      if(npar != 1 || ISNAN(par[0]) || par[0] <= 0. || par[0] >= 1.){
+        Rf_error("Geometric demand should give p in (0,1)");
+      }
+      break;
+    default:
+      Rf_error("unknown demand distribution");
+  }
+  model->par[0] = par[0];
+  model->par[1] = (npar > 1) ? par[1] : 0.;
+};
+
+void get_sis_model(sis_model* model, SEXP sR, SEXP SR, SEXP demandR, SEXP parR, SEXP lagR){
+
+  model->s = Rf_asInteger(sR);
+  model->S = Rf_asInteger(SR);
+  if(model->s == NA_INTEGER || model->S == NA_INTEGER || model->s < 0 || model->s >= model->S){
+    Rf_error("please set 0 <= s < S");
+  }
+
+  get_sis_demand(model, demandR, parR);
+
+  if(Rf_length(lagR) == 0){
+    model->lag_a = 0.;
+    model->lag_b = 0.;
+  } else if(Rf_length(lagR) == 2){
+    model->lag_a = REAL(lagR)[0];
+    model->lag_b = REAL(lagR)[1];
+    if(ISNAN(model->lag_a) || ISNAN(model->lag_b) || model->lag_a < 0. || model->lag_a > model->lag_b || model->lag_b > 1e6){
+      Rf_error("'lag' should satisfy 0 <= lag[1] <= lag[2]");
+    }
+  } else {
+    Rf_error("'lag' should give the bounds of the Uniform delivery lag");
+  }
+};
+
+SEXP sis_output(const double* stats){
+  SEXP out = PROTECT(Rf_allocVector(REALSXP, SIS_NSTAT));
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP, SIS_NSTAT));
+  for(int i=0; i<SIS_NSTAT; i++){
+    REAL(out)[i] = stats[i];
+    SET_STRING_ELT(nms, i, Rf_mkChar(sis_stat_names[i]));
+  }
+  Rf_namesgets(out, nms);
+  UNPROTECT(2);
+  return out;
+};
+
+static long sis_demand(const sis_model* model, rngs* r){
+  switch(model->demand){
+    case SIS_POISSON:
+      return rngs_poisson(r, model->par[0]);
+    case SIS_GEOMETRIC:
+      return rngs_geometric(r, model->par[0]);
+    default:
+      return rngs_equilikely(r, (long)model->par[0], (long)model->par[1]);
+  }
+};
+
+int sis_demands(const sis_model* model, rngs* r, int* out, size_t n){
+  int stream = r->stream;
+  rngs_select_stream(r, 0);
+  int ok = 1;
+  for(size_t i=0; i<n; i++){
+    long dem = sis_demand(model, r);
+    if(dem > INT_MAX){
+      ok = 0;
+      dem = INT_MAX;
+    }
+    out[i] = (int)dem;
+  }
+  r->stream = stream;
+  return ok;
+};
+
+/* time integrals of the held (+) and short (-) inventory over len time units, starting at level x
+   and falling at rate d; with len = 1 and x >= 0 these are the formulas of program sis1 */
+static void sis_segment(double x, double d, double len, double* hold, double* shortage){
+  if(d <= 0.){
+    if(x > 0.){
+      *hold += x * len;
+    } else {
+      *shortage -= x * len;
+    }
+  } else if(x > d * len){
+    *hold += x * len - 0.5 * d * len * len;
+  } else if(x > 0.){
+    *hold += (x * x) / (2.0 * d);
+    *shortage += (d * len - x) * (d * len - x) / (2.0 * d);
+  } else {
+    *shortage += -x * len + 0.5 * d * len * len;
+  }
+};
+
+/* an order in transit */
+typedef struct sis_order {
+  double  due;    /* delivery time */
+  int64_t amount;
+} sis_order;
+
+int sis2_run(const sis_model* model, int64_t intervals, rngs* r, double* out){
+
+  /* at most one order is placed per interval, so no more than ceil(lag_b) + 1 are ever in transit */
+  int cap = (int)ceil(model->lag_b) + 2;
+  sis_order* transit = (sis_order*)malloc(sizeof(sis_order) * cap);
+  if(transit == NULL){
+    return 0;
+  }
+  int ntransit = 0;
+  int64_t outstanding = 0;  /* total amount in transit */
+
+  int64_t inv = model->S;   /* current inventory level */
+
+  struct {                  /* sum of ...             */
+    double setup;           /*   setups               */
+    double holding;         /*   inventory held (+)   */
+    double shortage;        /*   inventory short (-)  */
+    double order;           /*   orders               */
+    double demand;          /*   demands              */
+  } sum = {0.0, 0.0, 0.0, 0.0, 0.0};
+
+  int stream = r->stream; /* restored on exit */
+
+  for(int64_t i=0; i<intervals; i++){
+
+    double start = (double)i;
+
+    /* a lag is drawn every interval and used only if an order is placed, so stream 1 (like
+       stream 0) advances by exactly one draw per interval and replications can be jumped to */
+    double lag = 0.;
+    if(model->lag_b > 0.){
+      rngs_select_stream(r, 1);
+      lag = rngs_uniform(r, model->lag_a, model->lag_b);
+    }
+
+    /* review the inventory position */
+    if(inv + outstanding < model->s){
+      int64_t ord = model->S - (inv + outstanding);
+      sum.setup += 1.;
+      sum.order += (double)ord;
+      if(lag == 0.){
+        inv += ord; /* no delivery lag */
+      } else {
+        transit[ntransit].due = start + lag;
+        transit[ntransit].amount = ord;
+        ntransit++;
+        outstanding += ord;
+      }
+    }
+
+    rngs_select_stream(r, 0);
+    int64_t dem = sis_demand(model, r);
+    sum.demand += (double)dem;
+
+    /* deliveries due in this interval, in time order, split it into segments */
+    double t = 0.;               /* time into the interval      */
+    double level = (double)inv;  /* level at time t             */
+    for(;;){
+      int next = -1;
+      for(int k=0; k<ntransit; k++){
+        if(transit[k].due < start + 1. && (next < 0 || transit[k].due < transit[next].due)){
+          next = k;
+        }
+      }
+      if(next < 0){
+        break;
+      }
+      double at = transit[next].due - start;
+      sis_segment(level, (double)dem, at - t, &sum.holding, &sum.shortage);
+      level -= (double)dem * (at - t);
+      level += (double)transit[next].amount;
+      t = at;
+      inv += transit[next].amount;
+      outstanding -= transit[next].amount;
+      transit[next] = transit[--ntransit];
+    }
+    sis_segment(level, (double)dem, 1. - t, &sum.holding, &sum.shortage);
+
+    inv -= dem;
+  }
+
+  /* final time step: orders in transit arrive and a last order restores the level to S */
+  inv += outstanding;
+  if(inv < model->S){
+    sum.setup += 1.;
+    sum.order += (double)(model->S - inv);
+  }
+
+  r->stream = stream;
+  free(transit);
+
+  double n = (double)intervals;
+  out[0] = sum.setup / n;
+  out[1] = sum.holding / n;
+  out[2] = sum.shortage / n;
+  out[3] = sum.order / n;
+  out[4] = sum.demand / n;
+  return 1;
+};
+
+SEXP des_sis2_C(SEXP intervalsR, SEXP sR, SEXP SR, SEXP demandR, SEXP parR, SEXP lagR, SEXP rngR){
+
+  double intervals = Rf_asReal(intervalsR);
+  if(ISNAN(intervals) || intervals < 1. || intervals != floor(intervals) || intervals > 9007199254740992.){
+    Rf_error("'intervals' should be a positive integer");
+  }
+
+  sis_model model;
+  get_sis_model(&model, sR, SR, demandR, parR, lagR);
+  rngs* r = get_rngs(rngR);
+
+  double stats[SIS_NSTAT];
+  if(!sis2_run(&model, (int64_t)intervals, r, stats)){
+    Rf_error("unable to allocate memory for orders in transit");
+  }
+
+  return sis_output(stats);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   grid search over (s,S) policies with common random numbers
+#   every policy sees the same demand sequence (a trace, or generated once from stream 0 in
+#   chunks), so differences between policies are not swamped by sampling noise. Policies are
+#   packed into blocks of SIS_LANES that advance together (sis.c), and blocks are split across
+#   threads; each block owns its own state, so the result does not depend on the schedule
+-------------------------------------------------------------------------------- */
+
+#define SIS_GRID_CHUNK 16384 /* intervals of generated demand held at once */
+
+static const char* sis_grid_names[SIS_NSTAT + 3] = {"s", "S", "setup", "holding", "shortage", "order", "demand", "cost"};
+
+static int* sis_levels(SEXP x, const char* name){
+  int* v = INTEGER(x);
+  for(R_xlen_t i=0; i<XLENGTH(x); i++){
+    if(v[i] == NA_INTEGER || v[i] < 0){
+      Rf_error("'%s' should be non-negative integers", name);
+    }
+  }
+  return v;
+};
+
+SEXP des_sis_grid_C(SEXP sR, SEXP SR, SEXP demands, SEXP intervalsR, SEXP demandR, SEXP parR, SEXP costR, SEXP rngR, SEXP threadsR){
+
+  int ns = Rf_length(sR);
+  int nS = Rf_length(SR);
+  int* sv = sis_levels(sR, "s");
+  int* Sv = sis_levels(SR, "S");
+
+  if(Rf_length(costR) != 4){
+    Rf_error("'cost' should give the setup, holding, shortage and item costs");
+  }
+  double* c = REAL(costR);
+
+  int threads = Rf_asInteger(threadsR);
+  if(threads == NA_INTEGER || threads < 1){
+    Rf_error("'threads' should be a positive integer");
+  }
+
+  /* demand: a trace, or generated from stream 0 of rng */
+  int trace = !Rf_isNull(demands);
+  sis_model model;
+  rngs* r = NULL;
+  double intervals;
+  if(trace){
+    intervals = (double)XLENGTH(demands);
+    int* d = INTEGER(demands);
+    for(R_xlen_t i=0; i<XLENGTH(demands); i++){
+      if(d[i] == NA_INTEGER || d[i] < 0){
+        Rf_error("'demands' should be non-negative integers");
+      }
+    }
+  } else {
+    intervals = Rf_asReal(intervalsR);
+    get_sis_demand(&model, demandR, parR);
+    r = get_rngs(rngR);
+  }
+  if(ISNAN(intervals) || intervals < 1. || intervals != floor(intervals) || intervals > 9007199254740992.){
+    Rf_error("'intervals' should be a positive integer");
+  }
+
+  /* the pairs with s < S, in the column-major order of the cost matrix */
+  R_xlen_t np = 0;
+  for(int j=0; j<nS; j++){
+    for(int i=0; i<ns; i++){
+      np += (sv[i] < Sv[j]);
+    }
+  }
+  if(np == 0){
+    Rf_error("no pair with s < S");
+  }
+
+  R_xlen_t nb = (np + SIS_LANES - 1) / SIS_LANES;
+  sis_lanes* L = (sis_lanes*)R_alloc(nb, sizeof(sis_lanes)); /* released by R, even on interrupt */
+  {
+    double lane_s[SIS_LANES], lane_S[SIS_LANES];
+    R_xlen_t k = 0;
+    int l = 0;
+    for(int j=0; j<nS; j++){
+      for(int i=0; i<ns; i++){
+        if(sv[i] < Sv[j]){
+          lane_s[l] = (double)sv[i];
+          lane_S[l] = (double)Sv[j];
+          if(++l == SIS_LANES){
+            sis_lanes_init(&L[k++], lane_s, lane_S);
+            l = 0;
+          }
+        }
+      }
+    }
+    if(l > 0){
+      for(; l<SIS_LANES; l++){ /* unused lanes */
+        lane_s[l] = 0.;
+        lane_S[l] = 1.;
+      }
+      sis_lanes_init(&L[k], lane_s, lane_S);
+    }
+  }
+
+  int* chunk = trace ? NULL : (int*)R_alloc(SIS_GRID_CHUNK, sizeof(int));
+  int ok = 1;
+
+  for(double done=0.; done<intervals; ){
+    size_t n;
+    const int* d;
+    if(trace){
+      n = (size_t)intervals;
+      d = INTEGER(demands);
+    } else {
+      n = (intervals - done < SIS_GRID_CHUNK) ? (size_t)(intervals - done) : SIS_GRID_CHUNK;
+      int got = sis_demands(&model, r, chunk, n); /* every chunk, so the stream keeps advancing */
+      ok = ok && got;
+      d = chunk;
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+    for(R_xlen_t b=0; b<nb; b++){
+      sis_lanes_run(&L[b], d, n);
+    }
+    done += (double)n;
+    R_CheckUserInterrupt();
+  }
+  if(!ok){
+    Rf_warning("demands above %d were truncated", INT_MAX);
+  }
+
+  /* per-interval statistics and cost of each pair */
+  SEXP cost = PROTECT(Rf_allocMatrix(REALSXP, ns, nS));
+  SEXP stats = PROTECT(Rf_allocMatrix(REALSXP, np, SIS_NSTAT + 3));
+  double* cm = REAL(cost);
+  double* x = REAL(stats);
+  R_xlen_t best = 0;
+  {
+    double lane[SIS_KERNEL_NSTAT * SIS_LANES];
+    R_xlen_t k = 0;
+    for(int j=0; j<nS; j++){
+      for(int i=0; i<ns; i++){
+        R_xlen_t cell = i + (R_xlen_t)ns * j;
+        if(sv[i] >= Sv[j]){
+          cm[cell] = NA_REAL;
+          continue;
+        }
+        int l = (int)(k % SIS_LANES);
+        if(l == 0){
+          sis_lanes_finish(&L[k / SIS_LANES], lane);
+        }
+        double* o = lane + SIS_KERNEL_NSTAT * l;
+        double total = c[0] * o[0] + c[1] * o[1] + c[2] * o[2] + c[3] * o[3];
+        x[k] = (double)sv[i];
+        x[k + np] = (double)Sv[j];
+        for(int m=0; m<SIS_NSTAT; m++){
+          x[k + np * (m + 2)] = o[m];
+        }
+        x[k + np * (SIS_NSTAT + 2)] = total;
+        cm[cell] = total;
+        if(total < x[best + np * (SIS_NSTAT + 2)]){
+          best = k;
+        }
+        k++;
+      }
+    }
+  }
+
+  /* dimnames: the levels of s and S for the cost surface, statistic names for the pairs */
+  SEXP sn = PROTECT(Rf_coerceVector(sR, STRSXP));
+  SEXP Sn = PROTECT(Rf_coerceVector(SR, STRSXP));
+  SEXP dn = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(dn, 0, sn);
+  SET_VECTOR_ELT(dn, 1, Sn);
+  SEXP dnn = PROTECT(Rf_allocVector(STRSXP, 2));
+  SET_STRING_ELT(dnn, 0, Rf_mkChar("s"));
+  SET_STRING_ELT(dnn, 1, Rf_mkChar("S"));
+  Rf_namesgets(dn, dnn);
+  Rf_setAttrib(cost, R_DimNamesSymbol, dn);
+
+  SEXP stat_names = PROTECT(Rf_allocVector(STRSXP, SIS_NSTAT + 3));
+  for(int m=0; m<SIS_NSTAT + 3; m++){
+    SET_STRING_ELT(stat_names, m, Rf_mkChar(sis_grid_names[m]));
+  }
+  SEXP dns = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(dns, 1, stat_names);
+  Rf_setAttrib(stats, R_DimNamesSymbol, dns);
+
+  SEXP opt = PROTECT(Rf_allocVector(REALSXP, 3));
+  SEXP opt_names = PROTECT(Rf_allocVector(STRSXP, 3));
+  REAL(opt)[0] = x[best];
+  REAL(opt)[1] = x[best + np];
+  REAL(opt)[2] = x[best + np * (SIS_NSTAT + 2)];
+  SET_STRING_ELT(opt_names, 0, Rf_mkChar("s"));
+  SET_STRING_ELT(opt_names, 1, Rf_mkChar("S"));
+  SET_STRING_ELT(opt_names, 2, Rf_mkChar("cost"));
+  Rf_namesgets(opt, opt_names);
+
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 3));
+  SEXP out_names = PROTECT(Rf_allocVector(STRSXP, 3));
+  SET_VECTOR_ELT(out, 0, cost);
+  SET_VECTOR_ELT(out, 1, stats);
+  SET_VECTOR_ELT(out, 2, opt);
+  SET_STRING_ELT(out_names, 0, Rf_mkChar("cost"));
+  SET_STRING_ELT(out_names, 1, Rf_mkChar("stats"));
+  SET_STRING_ELT(out_names, 2, Rf_mkChar("best"));
+  Rf_namesgets(out, out_names);
+
+  UNPROTECT(12);
+  return out;
+};
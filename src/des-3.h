@@ -0,0 +1,135 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Algorithms from Ch. 3
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef DES_3_H
+#define DES_3_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <R.h>
+#include <Rinternals.h>
+#include <Rmath.h>
+
+#include "rng.h"
+#include "outstat.h" // for monitoring simulation output
+#include "bulk.h"
+
+
+/* --------------------------------------------------------------------------------
+#   single-server service node with generated arrivals and services
+-------------------------------------------------------------------------------- */
+
+/* model: Exponential(arrival) interarrival times (stream 0), Uniform(service_a, service_b) service times (stream 1) */
+typedef struct ssq_model {
+  double arrival;
+  double service_a;
+  double service_b;
+} ssq_model;
+
+/* statistics returned by the ssq programs, in this order */
+#define SSQ_NSTAT 8
+extern const char* ssq_stat_names[SSQ_NSTAT];
+
+/* read and check the model from R arguments */
+void get_ssq_model(ssq_model* model, SEXP arrivalR, SEXP serviceR);
+
+/* program ssq2 core: process jobs jobs, write SSQ_NSTAT statistics into out; if mon is not NULL each wait is fed to it */
+void ssq2_run(const ssq_model* model, int64_t jobs, rngs* r, outstat* mon, double* out);
+
+/* program ssq2: a single-server FIFO service node with generated arrival and service times */
+SEXP des_ssq2_C(SEXP jobsR, SEXP arrivalR, SEXP serviceR, SEXP rngR, SEXP monitorR);
+
+/* named numeric vector with the ssq statistics */
+SEXP ssq_output(const double* stats);
+
+
+/* --------------------------------------------------------------------------------
+#   simple (s,S) inventory system with generated demand and delivery lag
+-------------------------------------------------------------------------------- */
+
+#define SIS_EQUILIKELY 0 /* demand per interval Equilikely(a, b)      */
+#define SIS_POISSON    1 /* demand per interval Poisson(mu)           */
+#define SIS_GEOMETRIC  2 /* demand per interval Geometric(p)          */
+
+/* model: demand per interval from stream 0, delivery lag Uniform(lag_a, lag_b) from stream 1 (lag_b = 0 for none) */
+typedef struct sis_model {
+  int    s;       /* reorder point: order when the inventory position falls below s */
+  int    S;       /* order up to S                                                  */
+  int    demand;  /* SIS_EQUILIKELY, SIS_POISSON or SIS_GEOMETRIC                   */
+  double par[2];  /* its parameters                                                 */
+  double lag_a;
+  double lag_b;
+} sis_model;
+
+/* statistics returned by the sis programs, in this order */
+#define SIS_NSTAT 5
+extern const char* sis_stat_names[SIS_NSTAT];
+
+/* read and check the model from R arguments */
+void get_sis_model(sis_model* model, SEXP sR, SEXP SR, SEXP demandR, SEXP parR, SEXP lagR);
+
+/* read and check only the demand distribution (demand and par) */
+void get_sis_demand(sis_model* model, SEXP demandR, SEXP parR);
+
+/* n demands from stream 0, as program sis2 draws them; returns 0 if one exceeded INT_MAX (and was truncated) */
+int sis_demands(const sis_model* model, rngs* r, int* out, size_t n);
+
+/* program sis2 core: simulate intervals time intervals, write SIS_NSTAT averages into out; returns 0 if out of memory */
+int sis2_run(const sis_model* model, int64_t intervals, rngs* r, double* out);
+
+/* program sis2: a simple (s,S) inventory system with generated demand and random delivery lag */
+SEXP des_sis2_C(SEXP intervalsR, SEXP sR, SEXP SR, SEXP demandR, SEXP parR, SEXP lagR, SEXP rngR);
+
+/* named numeric vector with the sis statistics */
+SEXP sis_output(const double* stats);
+
+/* cost surface of (s,S) policies over one demand sequence (common random numbers) */
+SEXP des_sis_grid_C(SEXP sR, SEXP SR, SEXP demands, SEXP intervalsR, SEXP demandR, SEXP parR, SEXP costR, SEXP rngR, SEXP threadsR);
+
+
+/* --------------------------------------------------------------------------------
+#   library rngs: multi-stream Lehmer random number generator via external ptr
+-------------------------------------------------------------------------------- */
+
+/* get the rngs state behind an external pointer (errors if invalid) */
+rngs* get_rngs(SEXP ptr);
+
+void free_rngs_C(SEXP ptr);
+
+/* allocate a new set of 256 streams planted from seed */
+SEXP make_rngs_C(SEXP seedR);
+
+/* reset all streams, spaced RNG_JUMP apart, starting from seed */
+SEXP plant_seeds_rngs_C(SEXP ptr, SEXP seedR);
+
+/* select the current stream */
+SEXP select_stream_rngs_C(SEXP ptr, SEXP streamR);
+
+/* get/set the state of the current stream */
+SEXP get_seed_rngs_C(SEXP ptr);
+
+SEXP put_seed_rngs_C(SEXP ptr, SEXP seedR);
+
+/* advance the current stream by k states */
+SEXP skip_rngs_C(SEXP ptr, SEXP kR);
+
+/* sample the current stream */
+SEXP random_rngs_C(SEXP ptr);
+
+/* bulk variates from the current stream: write n values into out (if not NULL) or a new vector */
+SEXP random_n_rngs_C(SEXP ptr, SEXP nR, SEXP outR, SEXP engineR);
+
+SEXP uniform_rngs_C(SEXP ptr, SEXP nR, SEXP aR, SEXP bR, SEXP outR);
+
+SEXP equilikely_rngs_C(SEXP ptr, SEXP nR, SEXP aR, SEXP bR, SEXP outR);
+
+SEXP exponential_rngs_C(SEXP ptr, SEXP nR, SEXP muR, SEXP outR);
+
+#endif
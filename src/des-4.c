@@ -14,33 +14,118 @@
 #   algorithm 4.1.1: Welford's one pass algorithm
 -------------------------------------------------------------------------------- */
 
-SEXP des_4_1_1_C(SEXP sampleR){
+/* mean and standard deviation as a named vector */
+static SEXP welford_output(const welford* w){
+  SEXP out = PROTECT(Rf_allocVector(REALSXP,2));
+  REAL(out)[0] = (w->n > 0) ? w->xbar : NA_REAL;
+  REAL(out)[1] = (w->n > 0) ? welford_sd(w) : NA_REAL;
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP,2));
+  Rf_namesgets(out, nms);
+  SET_STRING_ELT(nms, 0, Rf_mkChar("xbar"));
+  SET_STRING_ELT(nms, 1, Rf_mkChar("s"));
 
-  int ntot = Rf_length(sampleR);
-  double* x = REAL(sampleR);
+  UNPROTECT(2);
+  return out;
+};
+
+static int get_threads(SEXP threadsR){
+  int threads = Rf_asInteger(threadsR);
+  if(threads == NA_INTEGER || threads < 1){
+    Rf_error("'threads' should be a positive integer");
+  }
+  return threads;
+};
 
-  int n = 0;
-  double xbar = 0.0;
-  double v = 0.0;
+SEXP des_4_1_1_C(SEXP sampleR, SEXP threadsR){
 
-  double d;
-  for(int i=0; i<ntot; i++){
-    n++;
-    d = x[i] - xbar;    /* temporary variable */
-    v = v + d * d * ((double)n - 1.) / (double)n;
-    xbar = xbar + d / (double)n;
+  int threads = get_threads(threadsR);
+
+  welford w;
+  welford_init(&w);
+  if(!welford_update_parallel(&w, REAL(sampleR), (size_t)XLENGTH(sampleR), threads)){
+    Rf_error("unable to allocate memory for %d threads", threads);
   }
 
-  double s = sqrt(v / (double)n);
+  return welford_output(&w);
+};
 
-  /* build SEXP objects to return to R */
-  SEXP out = PROTECT(Rf_allocVector(REALSXP,2));
-  REAL(out)[0] = xbar;
-  REAL(out)[1] = s;
-  SEXP nms = PROTECT(Rf_allocVector(STRSXP,2));
+
+/* --------------------------------------------------------------------------------
+#   Welford accumulator via external ptr: update batch by batch, query at any time
+-------------------------------------------------------------------------------- */
+
+welford* get_welford(SEXP ptr){
+  if(TYPEOF(ptr) != EXTPTRSXP){
+    Rf_error("'ptr' should be an external pointer made by 'make_welford'");
+  }
+  welford* w = (welford*)R_ExternalPtrAddr(ptr);
+  if(w == NULL){
+    Rf_error("'ptr' points to an accumulator that has already been freed");
+  }
+  return w;
+};
+
+void free_welford_C(SEXP ptr){
+  welford* w = (welford*)R_ExternalPtrAddr(ptr);
+  free(w);
+  R_ClearExternalPtr(ptr);
+};
+
+SEXP make_welford_C(void){
+
+  welford* w = malloc(sizeof(struct welford));
+  if(w == NULL){
+    Rf_error("unable to allocate memory for the accumulator");
+  }
+  welford_init(w);
+
+  /* return to R with function to free the memory when ptr goes out of scope */
+  SEXP ptr = PROTECT(R_MakeExternalPtr(w, R_NilValue, R_NilValue));
+  R_RegisterCFinalizerEx(ptr,free_welford_C,TRUE);
+  UNPROTECT(1);
+  return ptr;
+};
+
+SEXP update_welford_C(SEXP ptr, SEXP sampleR, SEXP threadsR){
+  welford* w = get_welford(ptr);
+  int threads = get_threads(threadsR);
+  if(!welford_update_parallel(w, REAL(sampleR), (size_t)XLENGTH(sampleR), threads)){
+    Rf_error("unable to allocate memory for %d threads", threads);
+  }
+  return R_NilValue;
+};
+
+SEXP merge_welford_C(SEXP ptr, SEXP otherR){
+  welford* w = get_welford(ptr);
+  welford* other = get_welford(otherR);
+  if(w == other){
+    /* merging with itself doubles every observation */
+    welford copy = *other;
+    welford_merge(w, &copy);
+  } else {
+    welford_merge(w, other);
+  }
+  return R_NilValue;
+};
+
+SEXP query_welford_C(SEXP ptr){
+  welford* w = get_welford(ptr);
+  int empty = (w->n == 0);
+
+  SEXP out = PROTECT(Rf_allocVector(REALSXP,5));
+  REAL(out)[0] = (double)w->n;
+  REAL(out)[1] = empty ? NA_REAL : w->xbar;
+  REAL(out)[2] = empty ? NA_REAL : welford_sd(w);
+  REAL(out)[3] = empty ? NA_REAL : w->min;
+  REAL(out)[4] = empty ? NA_REAL : w->max;
+
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP,5));
   Rf_namesgets(out, nms);
-  SET_STRING_ELT(nms, 0, Rf_mkChar("xbar"));
-  SET_STRING_ELT(nms, 1, Rf_mkChar("s"));
+  SET_STRING_ELT(nms, 0, Rf_mkChar("n"));
+  SET_STRING_ELT(nms, 1, Rf_mkChar("xbar"));
+  SET_STRING_ELT(nms, 2, Rf_mkChar("s"));
+  SET_STRING_ELT(nms, 3, Rf_mkChar("min"));
+  SET_STRING_ELT(nms, 4, Rf_mkChar("max"));
 
   UNPROTECT(2);
   return out;
@@ -91,3 +176,142 @@ SEXP des_4_2_1_C(SEXP aR, SEXP bR, SEXP dataR){
   UNPROTECT(3);
   return out; /* f(x) is (count[x−a] / n) */
 };
+
+
+/* --------------------------------------------------------------------------------
+#   histogram via external ptr: discrete (algorithm 4.2.1) or continuous (section 4.3) data,
+#   updated chunk by chunk
+-------------------------------------------------------------------------------- */
+
+hist* get_hist(SEXP ptr){
+  if(TYPEOF(ptr) != EXTPTRSXP){
+    Rf_error("'ptr' should be an external pointer made by 'make_hist'");
+  }
+  hist* h = (hist*)R_ExternalPtrAddr(ptr);
+  if(h == NULL){
+    Rf_error("'ptr' points to a histogram that has already been freed");
+  }
+  return h;
+};
+
+void free_hist_C(SEXP ptr){
+  hist* h = (hist*)R_ExternalPtrAddr(ptr);
+  if(h != NULL){
+    hist_free(h);
+    free(h);
+  }
+  R_ClearExternalPtr(ptr);
+};
+
+SEXP make_hist_C(SEXP aR, SEXP bR, SEXP kR){
+
+  hist* h = malloc(sizeof(struct hist));
+  if(h == NULL){
+    Rf_error("unable to allocate memory for the histogram");
+  }
+
+  int ok;
+  if(Rf_isNull(kR)){
+    int a = Rf_asInteger(aR);
+    int b = Rf_asInteger(bR);
+    if(a == NA_INTEGER || b == NA_INTEGER || a >= b || (double)b - (double)a >= (double)INT_MAX - 3.){
+      free(h);
+      Rf_error("'a' and 'b' should be integers with a < b");
+    }
+    ok = hist_init_discrete(h, a, b);
+  } else {
+    double a = Rf_asReal(aR);
+    double b = Rf_asReal(bR);
+    int k = Rf_asInteger(kR);
+    if(!R_FINITE(a) || !R_FINITE(b) || a >= b){
+      free(h);
+      Rf_error("'a' and 'b' should be finite with a < b");
+    }
+    if(k == NA_INTEGER || k < 1 || k > INT_MAX - 3){
+      free(h);
+      Rf_error("'k' should be a positive integer");
+    }
+    ok = hist_init_continuous(h, a, b, k);
+  }
+  if(!ok){
+    free(h);
+    Rf_error("unable to allocate memory for the histogram");
+  }
+
+  /* return to R with function to free the memory when ptr goes out of scope */
+  SEXP ptr = PROTECT(R_MakeExternalPtr(h, R_NilValue, R_NilValue));
+  R_RegisterCFinalizerEx(ptr,free_hist_C,TRUE);
+  UNPROTECT(1);
+  return ptr;
+};
+
+SEXP update_hist_C(SEXP ptr, SEXP dataR, SEXP threadsR){
+  hist* h = get_hist(ptr);
+  int threads = get_threads(threadsR);
+
+  /* discrete histograms count integers, continuous ones doubles */
+  int type = (h->type == HIST_DISCRETE) ? INTSXP : REALSXP;
+  SEXP data = PROTECT(Rf_coerceVector(dataR, type));
+  if(type == INTSXP){
+    hist_add_int(h, INTEGER(data), (size_t)XLENGTH(data), threads);
+  } else {
+    hist_add_double(h, REAL(data), (size_t)XLENGTH(data), threads);
+  }
+  UNPROTECT(1);
+  return R_NilValue;
+};
+
+SEXP merge_hist_C(SEXP ptr, SEXP otherR){
+  hist* h = get_hist(ptr);
+  hist* other = get_hist(otherR);
+  if(!hist_compatible(h, other)){
+    Rf_error("'ptr' and 'other' should have the same bins");
+  }
+  if(h == other){
+    for(int j=0; j<h->k+3; j++){
+      h->count[j] *= 2;
+    }
+  } else {
+    hist_merge(h, other);
+  }
+  return R_NilValue;
+};
+
+SEXP query_hist_C(SEXP ptr){
+  hist* h = get_hist(ptr);
+  int k = h->k;
+
+  /* bin values (discrete) or midpoints (continuous); counts as doubles, they may exceed INT_MAX */
+  SEXP x = PROTECT(Rf_allocVector(REALSXP,k));
+  SEXP count = PROTECT(Rf_allocVector(REALSXP,k));
+  double mid = (h->type == HIST_CONTINUOUS) ? 0.5 : 0.;
+  for(int j=0; j<k; j++){
+    REAL(x)[j] = h->lo + ((double)j + mid) * h->delta;
+    REAL(count)[j] = (double)h->count[j+1];
+  }
+
+  double xbar, s;
+  hist_moments(h, &xbar, &s);
+
+  SEXP out = PROTECT(Rf_allocVector(VECSXP,7));
+  SET_VECTOR_ELT(out,0,x);
+  SET_VECTOR_ELT(out,1,count);
+  SET_VECTOR_ELT(out,2,Rf_ScalarReal((double)h->count[0]));
+  SET_VECTOR_ELT(out,3,Rf_ScalarReal((double)h->count[k+1]));
+  SET_VECTOR_ELT(out,4,Rf_ScalarReal((double)h->count[k+2]));
+  SET_VECTOR_ELT(out,5,Rf_ScalarReal(ISNAN(xbar) ? NA_REAL : xbar));
+  SET_VECTOR_ELT(out,6,Rf_ScalarReal(ISNAN(s) ? NA_REAL : s));
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP,7));
+  SET_STRING_ELT(names,0,Rf_mkChar("x"));
+  SET_STRING_ELT(names,1,Rf_mkChar("count"));
+  SET_STRING_ELT(names,2,Rf_mkChar("outliers_lo"));
+  SET_STRING_ELT(names,3,Rf_mkChar("outliers_hi"));
+  SET_STRING_ELT(names,4,Rf_mkChar("missing"));
+  SET_STRING_ELT(names,5,Rf_mkChar("xbar"));
+  SET_STRING_ELT(names,6,Rf_mkChar("s"));
+
+  Rf_namesgets(out,names);
+  UNPROTECT(4);
+  return out;
+};
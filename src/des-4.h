@@ -19,16 +19,45 @@
 
 #include <R_ext/Utils.h> // for user interrupt checking
 
+#include "welford.h"
+#include "hist.h"
+
 
 /* --------------------------------------------------------------------------------
 #   functions
 -------------------------------------------------------------------------------- */
 
-/* algorithm 4.1.1: Welford's one pass algorithm */
-SEXP des_4_1_1_C(SEXP sampleR);
+/* algorithm 4.1.1: Welford's one pass algorithm (split across threads and lanes, then merged) */
+SEXP des_4_1_1_C(SEXP sampleR, SEXP threadsR);
+
+/* Welford accumulator via external ptr */
+welford* get_welford(SEXP ptr);
+
+void free_welford_C(SEXP ptr);
+
+SEXP make_welford_C(void);
+
+SEXP update_welford_C(SEXP ptr, SEXP sampleR, SEXP threadsR);
+
+SEXP merge_welford_C(SEXP ptr, SEXP otherR);
+
+SEXP query_welford_C(SEXP ptr);
 
 /* algorithm 4.2.1: discrete data histrogram */
 SEXP des_4_2_1_C(SEXP aR, SEXP bR, SEXP dataR);
 
+/* discrete or continuous histogram via external ptr */
+hist* get_hist(SEXP ptr);
+
+void free_hist_C(SEXP ptr);
+
+SEXP make_hist_C(SEXP aR, SEXP bR, SEXP kR);
+
+SEXP update_hist_C(SEXP ptr, SEXP dataR, SEXP threadsR);
+
+SEXP merge_hist_C(SEXP ptr, SEXP otherR);
+
+SEXP query_hist_C(SEXP ptr);
+
 
 #endif
@@ -0,0 +1,451 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Algorithms from Ch. 5
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "des-5.h"
+
+
+/* --------------------------------------------------------------------------------
+#   program ssq3: next-event simulation of a single-server FIFO service node with infinite capacity
+-------------------------------------------------------------------------------- */
+
+/* event types; the type is also the tie-breaking seq, so an arrival at the same time as a completion goes first */
+#define SSQ3_ARRIVAL    0
+#define SSQ3_COMPLETION 1
+
+int ssq3_run(const ssq_model* model, double stop, int64_t jobs, rngs* r, double* out){
+
+  /* at most one arrival and one completion are pending, so pushes never need to grow the heap */
+  event_heap events;
+  if(!init_event_heap(&events, 2)){
+    return 0;
+  }
+
+  struct {
+    double current;    /* current time                        */
+    double last;       /* last arrival time                   */
+  } t;
+
+  struct {
+    double node;       /* time integrated number in the node  */
+    double queue;      /* time integrated number in the queue */
+    double service;    /* time integrated number in service   */
+  } area = {0.0, 0.0, 0.0};
+
+  int64_t index = 0;   /* used to count departed jobs         */
+  int64_t number = 0;  /* number in the node                  */
+  int64_t arrived = 0; /* used to count arrivals              */
+
+  int stream = r->stream; /* restored on exit */
+
+  t.current = 0.;
+  t.last = 0.;
+  rngs_select_stream(r, 0);
+  double arrival = rngs_exponential(r, model->arrival);
+  if(arrival <= stop){
+    event e = {arrival, SSQ3_ARRIVAL, SSQ3_ARRIVAL, 0};
+    insert_event_heap(&events, e);
+  }
+
+  while(events.size > 0){
+
+    event e = pop_event_heap(&events);
+
+    /* update integrals */
+    if(number > 0){
+      area.node += (e.time - t.current) * number;
+      area.queue += (e.time - t.current) * (number - 1);
+      area.service += (e.time - t.current);
+    }
+
+    /* advance the clock */
+    t.current = e.time;
+
+    if(e.type == SSQ3_ARRIVAL){
+      /* process an arrival */
+      number++;
+      arrived++;
+      t.last = t.current;
+      rngs_select_stream(r, 0);
+      arrival = t.current + rngs_exponential(r, model->arrival);
+      if(arrival <= stop && arrived < jobs){ /* otherwise close the door */
+        event a = {arrival, SSQ3_ARRIVAL, SSQ3_ARRIVAL, 0};
+        insert_event_heap(&events, a);
+      }
+      if(number == 1){
+        rngs_select_stream(r, 1);
+        event c = {t.current + rngs_uniform(r, model->service_a, model->service_b), SSQ3_COMPLETION, SSQ3_COMPLETION, 0};
+        insert_event_heap(&events, c);
+      }
+    } else {
+      /* process a completion of service */
+      index++;
+      number--;
+      if(number > 0){
+        rngs_select_stream(r, 1);
+        event c = {t.current + rngs_uniform(r, model->service_a, model->service_b), SSQ3_COMPLETION, SSQ3_COMPLETION, 0};
+        insert_event_heap(&events, c);
+      }
+    }
+  }
+
+  free_event_heap(&events);
+  r->stream = stream;
+
+  double n = (double)index;
+  out[0] = n;
+  out[1] = t.last / n;                 /* interarrival time */
+  out[2] = area.node / n;              /* wait              */
+  out[3] = area.queue / n;             /* delay             */
+  out[4] = area.service / n;           /* service time      */
+  out[5] = area.node / t.current;      /* # in the node     */
+  out[6] = area.queue / t.current;     /* # in the queue    */
+  out[7] = area.service / t.current;   /* utilization       */
+  return 1;
+};
+
+SEXP des_ssq3_C(SEXP stopR, SEXP jobsR, SEXP arrivalR, SEXP serviceR, SEXP rngR){
+
+  double stop = Rf_asReal(stopR);
+  double jobs = Rf_asReal(jobsR);
+  if(ISNAN(stop) || stop <= 0.){
+    Rf_error("'stop' should be positive");
+  }
+  if(ISNAN(jobs) || jobs < 1. || (R_FINITE(jobs) && jobs != floor(jobs))){
+    Rf_error("'jobs' should be a positive integer");
+  }
+  if(!R_FINITE(stop) && !R_FINITE(jobs)){
+    Rf_error("at least one of 'stop' and 'jobs' should be finite");
+  }
+
+  ssq_model model;
+  get_ssq_model(&model, arrivalR, serviceR);
+  rngs* r = get_rngs(rngR);
+
+  double stats[SSQ_NSTAT];
+  if(!ssq3_run(&model, stop, (jobs > 9e18) ? INT64_MAX : (int64_t)jobs, r, stats)){
+    Rf_error("unable to allocate memory for the event list");
+  }
+
+  if(stats[0] == 0.){
+    Rf_error("no jobs arrived before 'stop'");
+  }
+  return ssq_output(stats);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   program msq: a multi-server FIFO service node; jobs are served in order of arrival, each by
+#   an idle server chosen by the policy if there is one, otherwise by the first server to be free
+-------------------------------------------------------------------------------- */
+
+/* both heaps are sized for all c servers when initialized, so inserts never grow (or fail) */
+static inline void slot_push(event_heap* h, double key, int id){
+  event e = {key, (uint64_t)id, 0, id};
+  insert_event_heap(h, e);
+};
+
+/* key of an idle server under the policy */
+static inline double idle_key(const msq* ms, int id){
+  switch(ms->policy){
+    case MSQ_LOWEST_INDEX:
+      return (double)id;
+    case MSQ_LEAST_UTILIZED:
+      return ms->srv[id].busy;
+    default:
+      return ms->srv[id].free;
+  }
+};
+
+static inline int idle_count(const msq* ms){
+  return (ms->policy == MSQ_RANDOM) ? ms->npool : (int)ms->idle.size;
+};
+
+static void idle_push(msq* ms, int id){
+  if(ms->policy == MSQ_RANDOM){
+    ms->pool[ms->npool++] = id;
+  } else {
+    slot_push(&ms->idle, idle_key(ms, id), id);
+  }
+};
+
+static int idle_pop(msq* ms, rngs* r){
+  if(ms->policy == MSQ_RANDOM){
+    int stream = r->stream;
+    rngs_select_stream(r, 2);
+    long k = rngs_equilikely(r, 0, ms->npool - 1);
+    r->stream = stream;
+    int id = ms->pool[k];
+    ms->pool[k] = ms->pool[--ms->npool];
+    return id;
+  }
+  return pop_event_heap(&ms->idle).id;
+};
+
+int msq_init(msq* ms, int c, int policy){
+  memset(ms, 0, sizeof(msq));
+  ms->c = c;
+  ms->policy = policy;
+  ms->srv = (msq_server*)calloc(c, sizeof(msq_server));
+  int ok = (ms->srv != NULL);
+  ok = init_event_heap(&ms->busy, c) && ok;
+  if(policy == MSQ_RANDOM){
+    ms->pool = (int*)malloc(sizeof(int) * c);
+    ok = ok && (ms->pool != NULL);
+  } else {
+    ok = init_event_heap(&ms->idle, c) && ok;
+  }
+  if(!ok){
+    msq_free(ms);
+    return 0;
+  }
+  for(int j=0; j<c; j++){
+    idle_push(ms, j);
+  }
+  return 1;
+};
+
+void msq_free(msq* ms){
+  free(ms->srv);
+  free(ms->pool);
+  free_event_heap(&ms->busy);
+  free_event_heap(&ms->idle);
+  ms->srv = NULL;
+  ms->pool = NULL;
+};
+
+void msq_job(msq* ms, double a, double s, rngs* r){
+
+  /* servers that have finished by time a are idle */
+  while(ms->busy.size > 0 && peek_event_heap(&ms->busy)->time <= a){
+    idle_push(ms, pop_event_heap(&ms->busy).id);
+  }
+
+  int id;
+  double start;
+  if(idle_count(ms) > 0){
+    id = idle_pop(ms, r);
+    start = a;
+  } else {
+    id = pop_event_heap(&ms->busy).id;
+    start = ms->srv[id].free;
+  }
+
+  double d = start - a;
+  msq_server* srv = &ms->srv[id];
+  srv->free = start + s;
+  srv->busy += s;
+  srv->served++;
+  slot_push(&ms->busy, srv->free, id);
+
+  ms->n++;
+  ms->a = a;
+  ms->end = (srv->free > ms->end) ? srv->free : ms->end;
+  ms->sum.d += d;
+  ms->sum.w += d + s;
+  ms->sum.s += s;
+};
+
+/* list with job statistics (as ssq, without utilization) and a matrix of server statistics */
+static SEXP msq_output(const msq* ms){
+
+  double n = (double)ms->n;
+
+  SEXP jobs = PROTECT(Rf_allocVector(REALSXP, 7));
+  REAL(jobs)[0] = n;
+  REAL(jobs)[1] = ms->a / n;          /* interarrival time */
+  REAL(jobs)[2] = ms->sum.w / n;      /* wait              */
+  REAL(jobs)[3] = ms->sum.d / n;      /* delay             */
+  REAL(jobs)[4] = ms->sum.s / n;      /* service time      */
+  REAL(jobs)[5] = ms->sum.w / ms->end; /* # in the node    */
+  REAL(jobs)[6] = ms->sum.d / ms->end; /* # in the queue   */
+
+  SEXP jobs_names = PROTECT(Rf_allocVector(STRSXP, 7));
+  for(int i=0; i<7; i++){
+    SET_STRING_ELT(jobs_names, i, Rf_mkChar(ssq_stat_names[i]));
+  }
+  Rf_namesgets(jobs, jobs_names);
+
+  /* utilization, average service time and share of the jobs of each server */
+  int c = ms->c;
+  SEXP servers = PROTECT(Rf_allocMatrix(REALSXP, c, 3));
+  double* x = REAL(servers);
+  for(int j=0; j<c; j++){
+    const msq_server* srv = &ms->srv[j];
+    x[j] = srv->busy / ms->end;
+    x[j + c] = (srv->served > 0) ? srv->busy / (double)srv->served : NA_REAL;
+    x[j + 2*c] = (double)srv->served / n;
+  }
+
+  SEXP col_names = PROTECT(Rf_allocVector(STRSXP, 3));
+  SET_STRING_ELT(col_names, 0, Rf_mkChar("utilization"));
+  SET_STRING_ELT(col_names, 1, Rf_mkChar("service"));
+  SET_STRING_ELT(col_names, 2, Rf_mkChar("share"));
+  SEXP dn = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(dn, 1, col_names);
+  Rf_setAttrib(servers, R_DimNamesSymbol, dn);
+
+  SEXP out = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(out, 0, jobs);
+  SET_VECTOR_ELT(out, 1, servers);
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP, 2));
+  SET_STRING_ELT(names, 0, Rf_mkChar("jobs"));
+  SET_STRING_ELT(names, 1, Rf_mkChar("servers"));
+  Rf_namesgets(out, names);
+
+  UNPROTECT(7);
+  return out;
+};
+
+/* read the number of servers and policy, and set up the node */
+static void get_msq(msq* ms, SEXP serversR, SEXP policyR){
+  int c = Rf_asInteger(serversR);
+  int policy = Rf_asInteger(policyR);
+  if(c == NA_INTEGER || c < 1){
+    Rf_error("'servers' should be a positive integer");
+  }
+  if(policy == NA_INTEGER || policy < MSQ_LONGEST_IDLE || policy > MSQ_RANDOM){
+    Rf_error("unknown server selection policy");
+  }
+  if(!msq_init(ms, c, policy)){
+    Rf_error("unable to allocate memory for %d servers", c);
+  }
+};
+
+SEXP des_msq_C(SEXP jobsR, SEXP arrivalR, SEXP serviceR, SEXP serversR, SEXP policyR, SEXP rngR){
+
+  double jobs = Rf_asReal(jobsR);
+  if(ISNAN(jobs) || jobs < 1. || jobs != floor(jobs) || jobs > 9007199254740992.){
+    Rf_error("'jobs' should be a positive integer");
+  }
+
+  ssq_model model;
+  get_ssq_model(&model, arrivalR, serviceR);
+  rngs* r = get_rngs(rngR);
+
+  msq ms;
+  get_msq(&ms, serversR, policyR);
+
+  int stream = r->stream; /* restored on exit */
+  double arrival = 0.;
+  for(int64_t i=0; i<(int64_t)jobs; i++){
+    rngs_select_stream(r, 0);
+    arrival += rngs_exponential(r, model.arrival);
+    rngs_select_stream(r, 1);
+    double service = rngs_uniform(r, model.service_a, model.service_b);
+    msq_job(&ms, arrival, service, r);
+  }
+  r->stream = stream;
+
+  SEXP out = PROTECT(msq_output(&ms));
+  msq_free(&ms);
+  UNPROTECT(1);
+  return out;
+};
+
+SEXP des_msq_trace_C(SEXP arrivals, SEXP services, SEXP serversR, SEXP policyR, SEXP rngR){
+
+  R_xlen_t n = XLENGTH(arrivals);
+  if(XLENGTH(services) != n){
+    Rf_error("'arrivals' and 'services' vectors must be the same length");
+  }
+  if(n == 0){
+    Rf_error("the trace contains no jobs");
+  }
+
+  const double* a = REAL(arrivals);
+  const double* s = REAL(services);
+  for(R_xlen_t i=0; i<n; i++){
+    if(ISNAN(a[i]) || ISNAN(s[i]) || s[i] < 0. || (i > 0 && a[i] < a[i-1])){
+      Rf_error("arrival times should be non-decreasing and service times non-negative (job %.0f)", (double)(i + 1));
+    }
+  }
+
+  rngs* r = Rf_isNull(rngR) ? NULL : get_rngs(rngR);
+  if(r == NULL && Rf_asInteger(policyR) == MSQ_RANDOM){
+    Rf_error("random server selection needs 'rng'");
+  }
+
+  msq ms;
+  get_msq(&ms, serversR, policyR);
+
+  for(R_xlen_t i=0; i<n; i++){
+    msq_job(&ms, a[i], s[i], r);
+  }
+
+  SEXP out = PROTECT(msq_output(&ms));
+  msq_free(&ms);
+  UNPROTECT(1);
+  return out;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   the hold model on a future event list: pending events start Exponential(1) apart from 0,
+#   then each hold takes the most imminent event off and schedules one Exponential(1) later
+-------------------------------------------------------------------------------- */
+
+#define EVLIST_HEAP     0
+#define EVLIST_CALENDAR 1
+
+SEXP evlist_hold_C(SEXP pendingR, SEXP holdsR, SEXP listR, SEXP rngR){
+
+  double pending = Rf_asReal(pendingR);
+  double holds = Rf_asReal(holdsR);
+  int list = Rf_asInteger(listR);
+  if(ISNAN(pending) || pending < 1. || pending != floor(pending) || pending > INT_MAX){
+    Rf_error("'pending' should be a positive integer");
+  }
+  if(ISNAN(holds) || holds < 0. || holds != floor(holds) || holds > (double)R_XLEN_T_MAX / 2.){
+    Rf_error("'holds' should be a non-negative integer");
+  }
+  if(list != EVLIST_HEAP && list != EVLIST_CALENDAR){
+    Rf_error("unknown event list");
+  }
+  rngs* r = get_rngs(rngR);
+
+  /* time and seq of each event taken off the list */
+  R_xlen_t n = (R_xlen_t)holds;
+  SEXP out = PROTECT(Rf_allocMatrix(REALSXP, n, 2));
+  double* time = REAL(out);
+  double* seq = REAL(out) + n;
+
+  event_heap h;
+  calendar_queue q;
+  int ok = (list == EVLIST_HEAP) ? init_event_heap(&h, (size_t)pending) : init_calendar_queue(&q);
+  for(int i=0; ok && i<(int)pending; i++){
+    double t = rngs_exponential(r, 1.);
+    ok = (list == EVLIST_HEAP) ? push_event_heap(&h, t, 0, i) : push_calendar_queue(&q, t, 0, i);
+  }
+  for(R_xlen_t i=0; ok && i<n; i++){
+    event e = (list == EVLIST_HEAP) ? pop_event_heap(&h) : pop_calendar_queue(&q);
+    time[i] = e.time;
+    seq[i] = (double)e.seq;
+    double t = e.time + rngs_exponential(r, 1.);
+    ok = (list == EVLIST_HEAP) ? push_event_heap(&h, t, 0, e.id) : push_calendar_queue(&q, t, 0, e.id);
+  }
+  if(list == EVLIST_HEAP){
+    free_event_heap(&h);
+  } else {
+    free_calendar_queue(&q);
+  }
+  if(!ok){
+    Rf_error("unable to allocate memory for the event list");
+  }
+
+  SEXP col_names = PROTECT(Rf_allocVector(STRSXP, 2));
+  SET_STRING_ELT(col_names, 0, Rf_mkChar("time"));
+  SET_STRING_ELT(col_names, 1, Rf_mkChar("seq"));
+  SEXP dn = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(dn, 1, col_names);
+  Rf_setAttrib(out, R_DimNamesSymbol, dn);
+
+  UNPROTECT(3);
+  return out;
+};
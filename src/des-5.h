@@ -0,0 +1,90 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Algorithms from Ch. 5
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef DES_5_H
+#define DES_5_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <R.h>
+#include <Rinternals.h>
+#include <Rmath.h>
+
+#include "rng.h"
+#include "des-3.h" // for ssq_model and rngs external ptrs
+#include "evlist.h"
+
+
+/* --------------------------------------------------------------------------------
+#   multi-server FIFO service node, advanced one job at a time: servers that are busy wait
+#   in an event heap (evlist.h) on the time they become free, and idle servers in one on the
+#   selection policy (or an unordered array for random selection), so each job costs O(log c);
+#   in both heaps the server index is the tie-breaking seq, so ties go to the lower index
+-------------------------------------------------------------------------------- */
+
+#define MSQ_LONGEST_IDLE   0 /* idle server that has been idle longest (the book's choice) */
+#define MSQ_LOWEST_INDEX   1 /* idle server with the lowest index                          */
+#define MSQ_LEAST_UTILIZED 2 /* idle server with the least busy time so far                */
+#define MSQ_RANDOM         3 /* idle server chosen at random (stream 2)                     */
+
+typedef struct msq_server {
+  double  free;    /* time the server is next free (last departure)  */
+  double  busy;    /* total service time                             */
+  int64_t served;  /* number of jobs served                          */
+} msq_server;
+
+typedef struct msq {
+  int         c;       /* number of servers                                  */
+  int         policy;
+  msq_server* srv;
+  event_heap  busy;    /* servers in service, on (srv[].free, index)          */
+  event_heap  idle;    /* idle servers, on (policy key, index)                */
+  int*        pool;    /* idle servers in no particular order (MSQ_RANDOM)    */
+  int         npool;
+  int64_t     n;       /* number of jobs                                      */
+  double      a;       /* last arrival time                                   */
+  double      end;     /* last departure time                                 */
+  struct {             /* sum of ...                                          */
+    double d;          /*   delay times                                       */
+    double w;          /*   wait times                                        */
+    double s;          /*   service times                                     */
+  } sum;
+} msq;
+
+/* all c servers idle at time 0; returns 1 on success, 0 if out of memory */
+int msq_init(msq* ms, int c, int policy);
+
+void msq_free(msq* ms);
+
+/* job arrives at a (no earlier than the last) and needs service s; r is used by MSQ_RANDOM */
+void msq_job(msq* ms, double a, double s, rngs* r);
+
+
+/* --------------------------------------------------------------------------------
+#   functions
+-------------------------------------------------------------------------------- */
+
+/* program ssq3 core: next-event simulation until the door closes at time stop or after jobs arrivals, then the node empties;
+   returns 1 on success, 0 if out of memory */
+int ssq3_run(const ssq_model* model, double stop, int64_t jobs, rngs* r, double* out);
+
+/* program ssq3: next-event simulation of a single-server FIFO service node with infinite capacity */
+SEXP des_ssq3_C(SEXP stopR, SEXP jobsR, SEXP arrivalR, SEXP serviceR, SEXP rngR);
+
+/* program msq: multi-server FIFO service node with generated arrival (stream 0) and service (stream 1) times */
+SEXP des_msq_C(SEXP jobsR, SEXP arrivalR, SEXP serviceR, SEXP serversR, SEXP policyR, SEXP rngR);
+
+/* program msq with arrival and service times from vectors */
+SEXP des_msq_trace_C(SEXP arrivals, SEXP services, SEXP serversR, SEXP policyR, SEXP rngR);
+
+/* the hold model on a heap (list 0) or calendar queue (list 1): time and seq of the events taken off the list */
+SEXP evlist_hold_C(SEXP pendingR, SEXP holdsR, SEXP listR, SEXP rngR);
+
+#endif
@@ -0,0 +1,446 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Algorithms from Ch. 8
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "des-8.h"
+
+
+/* --------------------------------------------------------------------------------
+#   algorithm 8.1.1: interval estimation, xbar +/- t* s / sqrt(n-1) with s = sqrt(v/n)
+-------------------------------------------------------------------------------- */
+
+double t_halfwidth(const welford* w, double level){
+  if(w->n < 2){
+    return NA_REAL;
+  }
+  double tstar = Rf_qt(1. - (1. - level) / 2., (double)(w->n - 1), 1, 0);
+  return tstar * welford_sd(w) / sqrt((double)(w->n - 1));
+};
+
+static double get_level(SEXP levelR){
+  double level = Rf_asReal(levelR);
+  if(ISNAN(level) || level <= 0. || level >= 1.){
+    Rf_error("'level' should be in (0,1)");
+  }
+  return level;
+};
+
+static const char* interval_names[5] = {"n", "xbar", "s", "lower", "upper"};
+
+/* n, xbar, s, and the interval into out[0], out[stride], ..., out[4*stride] */
+static void interval_fill(const welford* w, double level, double* out, R_xlen_t stride){
+  double half = t_halfwidth(w, level);
+  int empty = (w->n == 0);
+
+  out[0] = (double)w->n;
+  out[stride] = empty ? NA_REAL : w->xbar;
+  out[2*stride] = empty ? NA_REAL : welford_sd(w);
+  out[3*stride] = ISNAN(half) ? NA_REAL : w->xbar - half;
+  out[4*stride] = ISNAN(half) ? NA_REAL : w->xbar + half;
+};
+
+/* xbar, s, and the interval as a named vector */
+static SEXP interval_output(const welford* w, double level){
+  SEXP out = PROTECT(Rf_allocVector(REALSXP,5));
+  interval_fill(w, level, REAL(out), 1);
+
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP,5));
+  Rf_namesgets(out, nms);
+  for(int i=0; i<5; i++){
+    SET_STRING_ELT(nms, i, Rf_mkChar(interval_names[i]));
+  }
+
+  UNPROTECT(2);
+  return out;
+};
+
+SEXP des_8_1_1_C(SEXP sampleR, SEXP levelR, SEXP threadsR){
+
+  double level = get_level(levelR);
+  int threads = Rf_asInteger(threadsR);
+  if(threads == NA_INTEGER || threads < 1){
+    Rf_error("'threads' should be a positive integer");
+  }
+
+  welford w;
+  welford_init(&w);
+  if(!welford_update_parallel(&w, REAL(sampleR), (size_t)XLENGTH(sampleR), threads)){
+    Rf_error("unable to allocate memory for %d threads", threads);
+  }
+
+  return interval_output(&w, level);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   output statistics via external ptr: fed one observation at a time (from R, or directly by a
+#   simulator), queried at any time
+-------------------------------------------------------------------------------- */
+
+outstat* get_outstat(SEXP ptr){
+  if(TYPEOF(ptr) != EXTPTRSXP){
+    Rf_error("'ptr' should be an external pointer made by 'make_output_stats'");
+  }
+  outstat* os = (outstat*)R_ExternalPtrAddr(ptr);
+  if(os == NULL){
+    Rf_error("'ptr' points to output statistics that have already been freed");
+  }
+  return os;
+};
+
+void free_outstat_C(SEXP ptr){
+  outstat* os = (outstat*)R_ExternalPtrAddr(ptr);
+  if(os != NULL){
+    outstat_free(os);
+    free(os);
+  }
+  R_ClearExternalPtr(ptr);
+};
+
+SEXP make_outstat_C(SEXP batchesR, SEXP lagR){
+
+  int nb = Rf_asInteger(batchesR);
+  int K = Rf_asInteger(lagR);
+  if(nb == NA_INTEGER || nb < 2 || nb > (1 << 24)){
+    Rf_error("'batches' should be an integer of at least 2");
+  }
+  if(K == NA_INTEGER || K < 0 || K > (1 << 24)){
+    Rf_error("'lag' should be a non-negative integer");
+  }
+
+  outstat* os = malloc(sizeof(struct outstat));
+  if(os == NULL || !outstat_init(os, nb, K)){
+    free(os);
+    Rf_error("unable to allocate memory for the output statistics");
+  }
+
+  /* return to R with function to free the memory when ptr goes out of scope */
+  SEXP ptr = PROTECT(R_MakeExternalPtr(os, R_NilValue, R_NilValue));
+  R_RegisterCFinalizerEx(ptr,free_outstat_C,TRUE);
+  UNPROTECT(1);
+  return ptr;
+};
+
+SEXP update_outstat_C(SEXP ptr, SEXP xR){
+  outstat* os = get_outstat(ptr);
+  double* x = REAL(xR);
+  R_xlen_t n = XLENGTH(xR);
+  for(R_xlen_t i=0; i<n; i++){
+    outstat_update(os, x[i]);
+  }
+  return R_NilValue;
+};
+
+SEXP query_outstat_C(SEXP ptr, SEXP levelR){
+  outstat* os = get_outstat(ptr);
+  double level = get_level(levelR);
+
+  /* every observation, as if independent */
+  SEXP all = PROTECT(interval_output(&os->all, level));
+
+  /* batch means: the grand mean of the complete batches, with k-1 degrees of freedom */
+  welford wb;
+  bm_summary(&os->bm, &wb);
+  SEXP batch = PROTECT(interval_output(&wb, level));
+
+  /* autocorrelation of lags 0,...,K */
+  int K = os->ac.K;
+  SEXP acf = PROTECT(Rf_allocVector(REALSXP,K+1));
+  if(os->ac.n > 0){
+    double* work = (double*)R_alloc(2 * ((size_t)K + 1), sizeof(double));
+    acs_result(&os->ac, REAL(acf), work);
+    for(int j=0; j<=K; j++){
+      if(!R_FINITE(REAL(acf)[j])){
+        REAL(acf)[j] = NA_REAL;
+      }
+    }
+  } else {
+    for(int j=0; j<=K; j++){
+      REAL(acf)[j] = NA_REAL;
+    }
+  }
+
+  SEXP out = PROTECT(Rf_allocVector(VECSXP,4));
+  SET_VECTOR_ELT(out,0,all);
+  SET_VECTOR_ELT(out,1,batch);
+  SET_VECTOR_ELT(out,2,Rf_ScalarReal((double)os->bm.b));
+  SET_VECTOR_ELT(out,3,acf);
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP,4));
+  SET_STRING_ELT(names,0,Rf_mkChar("all"));
+  SET_STRING_ELT(names,1,Rf_mkChar("batch"));
+  SET_STRING_ELT(names,2,Rf_mkChar("batch_size"));
+  SET_STRING_ELT(names,3,Rf_mkChar("acf"));
+
+  Rf_namesgets(out,names);
+  UNPROTECT(5);
+  return out;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   time-averaged statistics via external ptr; the names of the signals are kept in the
+#   protected slot of the pointer
+-------------------------------------------------------------------------------- */
+
+tavg* get_tavg(SEXP ptr){
+  if(TYPEOF(ptr) != EXTPTRSXP){
+    Rf_error("'ptr' should be an external pointer made by 'make_time_avg'");
+  }
+  tavg* ta = (tavg*)R_ExternalPtrAddr(ptr);
+  if(ta == NULL){
+    Rf_error("'ptr' points to time averages that have already been freed");
+  }
+  return ta;
+};
+
+void free_tavg_C(SEXP ptr){
+  tavg* ta = (tavg*)R_ExternalPtrAddr(ptr);
+  if(ta != NULL){
+    tavg_free(ta);
+    free(ta);
+  }
+  R_ClearExternalPtr(ptr);
+};
+
+SEXP make_tavg_C(SEXP valueR, SEXP t0R){
+
+  int p = Rf_length(valueR);
+  double t0 = Rf_asReal(t0R);
+  if(p < 1){
+    Rf_error("'value' should have at least one element");
+  }
+  if(!R_FINITE(t0)){
+    Rf_error("'t0' should be finite");
+  }
+
+  tavg* ta = malloc(sizeof(struct tavg));
+  if(ta == NULL || !tavg_init(ta, p, t0, REAL(valueR))){
+    free(ta);
+    Rf_error("unable to allocate memory for the time averages");
+  }
+
+  /* return to R with function to free the memory when ptr goes out of scope */
+  SEXP ptr = PROTECT(R_MakeExternalPtr(ta, R_NilValue, Rf_getAttrib(valueR, R_NamesSymbol)));
+  R_RegisterCFinalizerEx(ptr,free_tavg_C,TRUE);
+  UNPROTECT(1);
+  return ptr;
+};
+
+/* t[i] is the time of the i-th change and value[i + m*j] the new value of signal j */
+SEXP update_tavg_C(SEXP ptr, SEXP tR, SEXP valueR){
+  tavg* ta = get_tavg(ptr);
+  R_xlen_t m = XLENGTH(tR);
+  int p = ta->p;
+  if(XLENGTH(valueR) != m * p){
+    Rf_error("'value' should have one row of %d values for each element of 't'", p);
+  }
+
+  double* t = REAL(tR);
+  double* value = REAL(valueR);
+  double* row = (double*)R_alloc(p, sizeof(double));
+
+  for(R_xlen_t i=0; i<m; i++){
+    if(ISNAN(t[i]) || t[i] < ta->t){
+      Rf_error("'t' should be non-decreasing and no earlier than the last update");
+    }
+    for(int j=0; j<p; j++){
+      row[j] = value[i + m * j];
+    }
+    tavg_update(ta, t[i], row);
+  }
+  return R_NilValue;
+};
+
+SEXP query_tavg_C(SEXP ptr, SEXP tR){
+  tavg* ta = get_tavg(ptr);
+  double t = Rf_isNull(tR) ? ta->t : Rf_asReal(tR);
+  if(ISNAN(t) || t < ta->t){
+    Rf_error("'t' should be no earlier than the last update");
+  }
+
+  SEXP out = PROTECT(Rf_allocVector(REALSXP,ta->p));
+  tavg_mean(ta, t, REAL(out));
+  for(int j=0; j<ta->p; j++){
+    if(ISNAN(REAL(out)[j])){
+      REAL(out)[j] = NA_REAL;
+    }
+  }
+  Rf_setAttrib(out, R_NamesSymbol, R_ExternalPtrProtected(ptr));
+
+  UNPROTECT(1);
+  return out;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   independent replications: replication i runs on its own copy of the streams, each
+#   jumped ahead by i times the number of states a replication can consume, so replication
+#   i sees exactly the random numbers it would see if replications 0,...,i-1 had been run
+#   before it in sequence, no matter which thread runs it
+-------------------------------------------------------------------------------- */
+
+/* element of a named list; an error if the list has no names or no such element */
+static SEXP model_elt(SEXP list, const char* name){
+  SEXP nms = Rf_getAttrib(list, R_NamesSymbol);
+  if(!Rf_isString(nms) || XLENGTH(nms) != XLENGTH(list)){
+    Rf_error("model descriptor should be a named list");
+  }
+  for(R_xlen_t i=0; i<XLENGTH(list); i++){
+    if(STRING_ELT(nms, i) != NA_STRING && strcmp(CHAR(STRING_ELT(nms, i)), name) == 0){
+      return VECTOR_ELT(list, i);
+    }
+  }
+  Rf_error("model descriptor is missing '%s'", name);
+  return R_NilValue;
+};
+
+void get_rep_model(rep_model* model, SEXP modelR){
+
+  memset(model, 0, sizeof(rep_model));
+
+  if(TYPEOF(modelR) != VECSXP || !Rf_inherits(modelR, "des_model")){
+    Rf_error("'model' should be a model descriptor made by 'ssq_model' or 'sis_model'");
+  }
+
+  double size = Rf_asReal(model_elt(modelR, "size"));
+  if(ISNAN(size) || size < 1. || size != floor(size) || size > 9007199254740992.){
+    Rf_error("model 'size' should be a positive integer");
+  }
+  model->size = (int64_t)size;
+
+  SEXP typeR = model_elt(modelR, "type");
+  if(!Rf_isString(typeR) || XLENGTH(typeR) != 1 || STRING_ELT(typeR, 0) == NA_STRING){
+    Rf_error("model 'type' should be a single string");
+  }
+  const char* type = CHAR(STRING_ELT(typeR, 0));
+
+  if(strcmp(type, "ssq2") == 0){
+    model->type = MODEL_SSQ2;
+    get_ssq_model(&model->ssq, model_elt(modelR, "arrival"), model_elt(modelR, "service"));
+    model->nstat = SSQ_NSTAT;
+    model->names = ssq_stat_names;
+    model->streams = 2;               /* one arrival and one service time per job */
+    model->draws = (uint64_t)model->size;
+  } else if(strcmp(type, "sis2") == 0){
+    model->type = MODEL_SIS2;
+    get_sis_model(&model->sis, model_elt(modelR, "s"), model_elt(modelR, "S"), model_elt(modelR, "demand"),
+                  model_elt(modelR, "par"), model_elt(modelR, "lag"));
+    model->nstat = SIS_NSTAT;
+    model->names = sis_stat_names;
+    model->streams = 2;               /* one demand and one delivery lag (used or not) per interval */
+    model->draws = (uint64_t)model->size;
+  } else {
+    Rf_error("unknown model type '%s'", type);
+  }
+};
+
+void rep_model_run(const rep_model* model, rngs* r, double* out){
+  switch(model->type){
+    case MODEL_SSQ2:
+      ssq2_run(&model->ssq, model->size, r, NULL, out);
+      break;
+    case MODEL_SIS2:
+      if(!sis2_run(&model->sis, model->size, r, out)){
+        for(int j=0; j<SIS_NSTAT; j++){
+          out[j] = NA_REAL;
+        }
+      }
+      break;
+  }
+};
+
+SEXP des_replicate_C(SEXP modelR, SEXP repsR, SEXP seedR, SEXP levelR, SEXP threadsR){
+
+  rep_model model;
+  get_rep_model(&model, modelR);
+
+  int reps = Rf_asInteger(repsR);
+  if(reps == NA_INTEGER || reps < 1){
+    Rf_error("'reps' should be a positive integer");
+  }
+  double seed = Rf_asReal(seedR);
+  if(ISNAN(seed) || seed < 1. || seed >= (double)RNG_MODULUS || seed != floor(seed)){
+    Rf_error("'seed' should be an integer in 1,...,2147483646");
+  }
+  double level = get_level(levelR);
+  int threads = Rf_asInteger(threadsR);
+  if(threads == NA_INTEGER || threads < 1){
+    Rf_error("'threads' should be a positive integer");
+  }
+
+  /* replications laid end to end must fit between the starts of adjacent streams */
+  if((double)reps * (double)model.draws > (double)RNG_JUMP){
+    Rf_warning("%d replications use more than %ld states of each stream; streams will overlap", reps, (long)RNG_JUMP);
+  }
+
+  rngs base;
+  rngs_plant_seeds(&base, (long)seed);
+  base.stream = 0;
+
+  int nstat = model.nstat;
+  SEXP stats = PROTECT(Rf_allocMatrix(REALSXP, reps, nstat));
+  double* x = REAL(stats);
+
+  /* each replication writes its own row, so the matrix does not depend on the schedule */
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+  for(int i=0; i<reps; i++){
+    rngs r = base;
+    for(int j=0; j<model.streams; j++){
+      r.seed[j] = rng_skip(base.seed[j], (uint64_t)i * model.draws);
+    }
+    double out[REP_MAXSTAT];
+    rep_model_run(&model, &r, out);
+    for(int j=0; j<nstat; j++){
+      x[i + (R_xlen_t)reps * j] = out[j];
+    }
+  }
+
+  /* interval estimate of the mean of each statistic across replications (serial, in order) */
+  SEXP interval = PROTECT(Rf_allocMatrix(REALSXP, nstat, 5));
+  for(int j=0; j<nstat; j++){
+    welford w;
+    welford_init(&w);
+    for(int i=0; i<reps; i++){
+      welford_update(&w, x[i + (R_xlen_t)reps * j]);
+    }
+    interval_fill(&w, level, REAL(interval) + j, nstat);
+  }
+
+  SEXP stat_names = PROTECT(Rf_allocVector(STRSXP, nstat));
+  for(int j=0; j<nstat; j++){
+    SET_STRING_ELT(stat_names, j, Rf_mkChar(model.names[j]));
+  }
+  SEXP col_names = PROTECT(Rf_allocVector(STRSXP, 5));
+  for(int j=0; j<5; j++){
+    SET_STRING_ELT(col_names, j, Rf_mkChar(interval_names[j]));
+  }
+
+  SEXP dn = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(dn, 1, stat_names);
+  Rf_setAttrib(stats, R_DimNamesSymbol, dn);
+
+  SEXP dni = PROTECT(Rf_allocVector(VECSXP, 2));
+  SET_VECTOR_ELT(dni, 0, stat_names);
+  SET_VECTOR_ELT(dni, 1, col_names);
+  Rf_setAttrib(interval, R_DimNamesSymbol, dni);
+
+  SEXP out = PROTECT(Rf_allocVector(VECSXP,2));
+  SET_VECTOR_ELT(out,0,stats);
+  SET_VECTOR_ELT(out,1,interval);
+
+  SEXP names = PROTECT(Rf_allocVector(STRSXP,2));
+  SET_STRING_ELT(names,0,Rf_mkChar("stats"));
+  SET_STRING_ELT(names,1,Rf_mkChar("interval"));
+
+  Rf_namesgets(out,names);
+  UNPROTECT(8);
+  return out;
+};
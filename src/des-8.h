@@ -0,0 +1,89 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Algorithms from Ch. 8
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef DES_8_H
+#define DES_8_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <R.h>
+#include <Rinternals.h>
+#include <Rmath.h>
+
+#include "welford.h"
+#include "outstat.h"
+#include "rng.h"
+#include "des-3.h" // for the models run by des_replicate_C
+
+
+/* --------------------------------------------------------------------------------
+#   models for independent replications
+-------------------------------------------------------------------------------- */
+
+#define MODEL_SSQ2 0  /* program ssq2 (des-3.c), size is the number of jobs      */
+#define MODEL_SIS2 1  /* program sis2 (des-3.c), size is the number of intervals */
+
+/* largest number of statistics a model returns */
+#define REP_MAXSTAT 16
+
+typedef struct rep_model {
+  int          type;
+  int64_t      size;     /* length of one replication, in jobs or intervals */
+  int          nstat;    /* number of statistics returned ...               */
+  const char** names;    /*   ... and their names                           */
+  int          streams;  /* the model uses streams 0,...,streams-1 ...      */
+  uint64_t     draws;    /*   ... and at most this many states of each      */
+  ssq_model    ssq;      /* MODEL_SSQ2                                      */
+  sis_model    sis;      /* MODEL_SIS2                                      */
+} rep_model;
+
+/* read a 'des_model' descriptor from R */
+void get_rep_model(rep_model* model, SEXP modelR);
+
+/* run one replication from the current state of r, write model->nstat statistics into out */
+void rep_model_run(const rep_model* model, rngs* r, double* out);
+
+
+/* --------------------------------------------------------------------------------
+#   functions
+-------------------------------------------------------------------------------- */
+
+/* half-width of the Student-t interval for the mean of w->n observations (NA if fewer than 2) */
+double t_halfwidth(const welford* w, double level);
+
+/* algorithm 8.1.1: interval estimate of the mean */
+SEXP des_8_1_1_C(SEXP sampleR, SEXP levelR, SEXP threadsR);
+
+/* run independent replications of a model in parallel, with a Student-t interval for each statistic */
+SEXP des_replicate_C(SEXP modelR, SEXP repsR, SEXP seedR, SEXP levelR, SEXP threadsR);
+
+/* output statistics (mean, batch means, autocorrelation) via external ptr */
+outstat* get_outstat(SEXP ptr);
+
+void free_outstat_C(SEXP ptr);
+
+SEXP make_outstat_C(SEXP batchesR, SEXP lagR);
+
+SEXP update_outstat_C(SEXP ptr, SEXP xR);
+
+SEXP query_outstat_C(SEXP ptr, SEXP levelR);
+
+/* time-averaged statistics via external ptr */
+tavg* get_tavg(SEXP ptr);
+
+void free_tavg_C(SEXP ptr);
+
+SEXP make_tavg_C(SEXP valueR, SEXP t0R);
+
+SEXP update_tavg_C(SEXP ptr, SEXP tR, SEXP valueR);
+
+SEXP query_tavg_C(SEXP ptr, SEXP tR);
+
+#endif
@@ -45,56 +45,293 @@ int gcd(int a, int b){
 
 
 /* --------------------------------------------------------------------------------
-#   sieve of Eratosthenes
+#   sieve of Eratosthenes: segmented, odd numbers only, one bit per odd number
+#   odd n = 2j + 1 is stored as bit j; a set bit means composite. Segments of SIEVE_SEG_BITS bits
+#   (32 KiB, one L1 cache) are sieved independently, so memory is bounded and segments can run on
+#   separate threads. Multiples of 3, 5, 7, 11 and 13 are copied in from a precomputed wheel pattern
+#   and only the remaining base primes are crossed off, starting from p^2.
 -------------------------------------------------------------------------------- */
 
-SEXP sieve_C(SEXP NR){
+#define SIEVE_SEG_BITS (1 << 18)
+#define SIEVE_SEG_WORDS (SIEVE_SEG_BITS / 64)
 
-  int N = Rf_asInteger(NR);
+/* the wheel: bit j set iff 2j+1 is divisible by 3, 5, 7, 11 or 13; period 3*5*7*11*13 in j */
+#define SIEVE_WHEEL 15015
+#define SIEVE_WHEEL_WORDS (SIEVE_WHEEL / 64 + 3)
 
-  if(N <= 2){
+/* largest N accepted: base primes up to 2^25 */
+#define SIEVE_MAX 1125899906842624.0
+
+typedef struct sieve_ctx {
+  uint64_t  jlo, jhi;   /* odd indices to report, inclusive           */
+  uint32_t* base;       /* odd primes 17 <= p <= sqrt(N)              */
+  size_t    nbase;
+  uint64_t  wheel[SIEVE_WHEEL_WORDS];
+} sieve_ctx;
+
+/* returns 0 if memory could not be allocated */
+static int sieve_init(sieve_ctx* ctx, uint64_t lo, uint64_t hi){
+
+  /* odd numbers 3 <= n in [lo, hi] */
+  uint64_t nlo = (lo < 3) ? 3 : (lo | 1);
+  uint64_t nhi = (hi % 2 == 0) ? hi - 1 : hi;
+  ctx->jlo = (nlo - 1) / 2;
+  ctx->jhi = (nhi - 1) / 2;
+
+  /* base primes by a plain byte sieve up to sqrt(hi) */
+  uint64_t r = (uint64_t)sqrt((double)hi);
+  while(r * r > hi){
+    r--;
+  }
+  while((r + 1) * (r + 1) <= hi){
+    r++;
+  }
+  unsigned char* comp = (unsigned char*)calloc(r + 1, 1);
+  ctx->base = (uint32_t*)malloc(sizeof(uint32_t) * (r / 2 + 1));
+  ctx->nbase = 0;
+  if(!comp || !ctx->base){
+    free(comp);
+    free(ctx->base);
+    ctx->base = NULL;
+    return 0;
+  }
+  for(uint64_t p=3; p<=r; p+=2){
+    if(!comp[p]){
+      if(p >= 17){
+        ctx->base[ctx->nbase++] = (uint32_t)p;
+      }
+      for(uint64_t k=p*p; k<=r; k+=2*p){
+        comp[k] = 1;
+      }
+    }
+  }
+  free(comp);
+
+  /* wheel pattern, with its first 128 bits repeated at the end so any 64 bits can be read at once */
+  memset(ctx->wheel, 0, sizeof(ctx->wheel));
+  for(uint64_t j=0; j<SIEVE_WHEEL + 128 && j<64*SIEVE_WHEEL_WORDS; j++){
+    uint64_t n = 2 * (j % SIEVE_WHEEL) + 1;
+    if(n % 3 == 0 || n % 5 == 0 || n % 7 == 0 || n % 11 == 0 || n % 13 == 0){
+      ctx->wheel[j >> 6] |= (uint64_t)1 << (j & 63);
+    }
+  }
+  return 1;
+};
+
+static void sieve_free(sieve_ctx* ctx){
+  free(ctx->base);
+};
+
+/* sieve odd indices j0,...,j0+nbits-1 into bits (nbits <= SIEVE_SEG_BITS) */
+static void sieve_segment(const sieve_ctx* ctx, uint64_t j0, uint64_t nbits, uint64_t* bits){
+
+  /* copy in the wheel */
+  uint64_t nwords = (nbits + 63) / 64;
+  uint64_t off = j0 % SIEVE_WHEEL;
+  for(uint64_t w=0; w<nwords; w++){
+    uint64_t i = off >> 6;
+    uint64_t s = off & 63;
+    bits[w] = (s == 0) ? ctx->wheel[i] : (ctx->wheel[i] >> s) | (ctx->wheel[i+1] << (64 - s));
+    off += 64;
+    if(off >= SIEVE_WHEEL){
+      off -= SIEVE_WHEEL;
+    }
+  }
+
+  /* 3, 5, 7, 11 and 13 are prime themselves (j = 1, 2, 3, 5, 6); 1 (j = 0) is never in range */
+  static const uint64_t wheel_j[5] = {1, 2, 3, 5, 6};
+  for(int k=0; k<5; k++){
+    if(wheel_j[k] >= j0 && wheel_j[k] < j0 + nbits){
+      bits[(wheel_j[k] - j0) >> 6] &= ~((uint64_t)1 << ((wheel_j[k] - j0) & 63));
+    }
+  }
+
+  /* cross off odd multiples of the base primes, from p^2; odd multiples are p apart in j */
+  uint64_t nmax = 2 * (j0 + nbits - 1) + 1;
+  for(size_t k=0; k<ctx->nbase; k++){
+    uint64_t p = ctx->base[k];
+    if(p * p > nmax){
+      break;
+    }
+    uint64_t jstart = (p * p - 1) / 2;
+    if(jstart < j0){
+      /* first j >= j0 with 2j + 1 = 0 mod p, i.e. j = (p - 1)/2 mod p */
+      uint64_t jr = (p - 1) / 2;
+      jstart = j0 + (jr + p - j0 % p) % p;
+    }
+    for(uint64_t j=jstart-j0; j<nbits; j+=p){
+      bits[j >> 6] |= (uint64_t)1 << (j & 63);
+    }
+  }
+
+  /* mark the bits past the end of the segment */
+  if(nbits & 63){
+    bits[nwords-1] |= ~(uint64_t)0 << (nbits & 63);
+  }
+};
+
+static uint64_t sieve_count_bits(const uint64_t* bits, uint64_t nbits){
+  uint64_t count = 0;
+  for(uint64_t w=0; w<(nbits + 63)/64; w++){
+    count += (uint64_t)__builtin_popcountll(~bits[w]);
+  }
+  return count;
+};
+
+SEXP sieve_C(SEXP NR, SEXP loR, SEXP countR, SEXP threadsR){
+
+  double Nd = Rf_asReal(NR);
+  double lod = Rf_asReal(loR);
+  int count_only = Rf_asLogical(countR);
+  int threads = Rf_asInteger(threadsR);
+
+  if(ISNAN(Nd) || Nd <= 2){
     Rf_error("'N' should be greater than 2");
   }
+  if(Nd > SIEVE_MAX){
+    Rf_error("'N' should be at most 2^50");
+  }
+  if(ISNAN(lod) || lod < 0){
+    Rf_error("'lo' should be non-negative");
+  }
+  if(threads == NA_INTEGER || threads < 1){
+    Rf_error("'threads' should be a positive integer");
+  }
+
+  uint64_t hi = (uint64_t)floor(Nd);
+  uint64_t lo = (uint64_t)ceil(lod);
+  int has_two = (lo <= 2 && hi >= 2);
+
+  if(lo > hi){
+    return count_only ? Rf_ScalarReal(0.) : Rf_allocVector(INTSXP, 0);
+  }
+
+  sieve_ctx ctx;
+  if(!sieve_init(&ctx, lo, hi)){
+    Rf_error("unable to allocate memory for the base primes");
+  }
 
-  int n;
-  int s; // step index
+  uint64_t nodd = (ctx.jhi >= ctx.jlo) ? ctx.jhi - ctx.jlo + 1 : 0;
+  int64_t nseg = (int64_t)((nodd + SIEVE_SEG_BITS - 1) / SIEVE_SEG_BITS);
 
-  /* initialize the sieve */
-  int prime[N+1];
-  prime[0] = 0;
-  prime[1] = 0;
-  for(n = 2; n <= N; n++){
-    prime[n] = 1;
+  /* pass 1: count the primes in every segment */
+  uint64_t* seg_count = (uint64_t*)calloc(nseg + 1, sizeof(uint64_t));
+  if(!seg_count){
+    sieve_free(&ctx);
+    Rf_error("unable to allocate memory for %.0f segment counts, use a smaller range", (double)nseg);
   }
 
-  /* run the sieve */
-  int sqrtN = (int)sqrt((double)N);
-  for(n = 2; n <= sqrtN; n++){
-    if(prime[n]){
-      for(s = 2; s <= (N/n); s++){
-        prime[s*n] = 0;
+  /* set by any thread that cannot allocate its segment; R is only called back once all threads are done */
+  int oom = 0;
+
+#ifdef _OPENMP
+  #pragma omp parallel num_threads(threads)
+#endif
+  {
+    uint64_t* bits = (uint64_t*)malloc(sizeof(uint64_t) * SIEVE_SEG_WORDS);
+    if(!bits){
+#ifdef _OPENMP
+      #pragma omp atomic write
+#endif
+      oom = 1;
+    }
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 4)
+#endif
+    for(int64_t s=0; s<nseg; s++){
+      if(!bits){
+        continue;
       }
+      uint64_t j0 = ctx.jlo + (uint64_t)s * SIEVE_SEG_BITS;
+      uint64_t nbits = (nodd - (uint64_t)s * SIEVE_SEG_BITS < SIEVE_SEG_BITS) ? nodd - (uint64_t)s * SIEVE_SEG_BITS : SIEVE_SEG_BITS;
+      sieve_segment(&ctx, j0, nbits, bits);
+      seg_count[s] = sieve_count_bits(bits, nbits);
     }
+    free(bits);
   }
 
-  /* number of primes (to fill output) */
-  int np = 0;
-  for(n=0; n<=N; n++){
-    if(prime[n]){
-      np++;
+  if(oom){
+    free(seg_count);
+    sieve_free(&ctx);
+    Rf_error("unable to allocate memory for the sieve segments");
+  }
+
+  uint64_t total = has_two;
+  for(int64_t s=0; s<nseg; s++){
+    uint64_t c = seg_count[s];
+    seg_count[s] = total; /* now the offset of the segment's first prime */
+    total += c;
+  }
+
+  if(count_only){
+    free(seg_count);
+    sieve_free(&ctx);
+    return Rf_ScalarReal((double)total);
+  }
+
+  /* pass 2: write each segment's primes at its offset (integers if they fit, doubles otherwise) */
+  int as_int = (hi <= (uint64_t)INT_MAX);
+  if(total > (uint64_t)R_XLEN_T_MAX){
+    free(seg_count);
+    sieve_free(&ctx);
+    Rf_error("too many primes to return, use 'count = TRUE' or a smaller range");
+  }
+  SEXP output = PROTECT(Rf_allocVector(as_int ? INTSXP : REALSXP, (R_xlen_t)total));
+  int* out_int = as_int ? INTEGER(output) : NULL;
+  double* out_real = as_int ? NULL : REAL(output);
+
+  if(has_two){
+    if(as_int){
+      out_int[0] = 2;
+    } else {
+      out_real[0] = 2.;
     }
   }
 
-  SEXP output = PROTECT(Rf_allocVector(INTSXP, np));
-  int* out_ptr = INTEGER(output);
-  int out_i = 0;
-  for(n = 0; n <= N; n++){
-    if(prime[n]){
-      out_ptr[out_i] = n;
-      out_i++;
+#ifdef _OPENMP
+  #pragma omp parallel num_threads(threads)
+#endif
+  {
+    uint64_t* bits = (uint64_t*)malloc(sizeof(uint64_t) * SIEVE_SEG_WORDS);
+    if(!bits){
+#ifdef _OPENMP
+      #pragma omp atomic write
+#endif
+      oom = 1;
+    }
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 4)
+#endif
+    for(int64_t s=0; s<nseg; s++){
+      if(!bits){
+        continue;
+      }
+      uint64_t j0 = ctx.jlo + (uint64_t)s * SIEVE_SEG_BITS;
+      uint64_t nbits = (nodd - (uint64_t)s * SIEVE_SEG_BITS < SIEVE_SEG_BITS) ? nodd - (uint64_t)s * SIEVE_SEG_BITS : SIEVE_SEG_BITS;
+      sieve_segment(&ctx, j0, nbits, bits);
+
+      uint64_t i = seg_count[s];
+      for(uint64_t w=0; w<(nbits + 63)/64; w++){
+        uint64_t x = ~bits[w];
+        while(x){
+          uint64_t n = 2 * (j0 + 64 * w + (uint64_t)__builtin_ctzll(x)) + 1;
+          if(as_int){
+            out_int[i++] = (int)n;
+          } else {
+            out_real[i++] = (double)n;
+          }
+          x &= x - 1;
+        }
+      }
     }
+    free(bits);
   }
 
+  free(seg_count);
+  sieve_free(&ctx);
+  if(oom){
+    Rf_error("unable to allocate memory for the sieve segments");
+  }
   UNPROTECT(1);
   return output;
 };
@@ -136,3 +373,78 @@ int* approx_factor(const int a, const int M){
 
   return out;
 };
+
+/* 64-bit version; q and r have the same type (double or integer64) as m */
+SEXP approx_factor_64_C(SEXP aR, SEXP MR){
+
+  int64_t a = as_int64(aR, "a");
+  int64_t m = as_int64(MR, "m");
+  if(a <= 0 || m <= 0){
+    Rf_error("'a' and 'm' should be positive");
+  }
+
+  SEXP output = PROTECT(alloc_int64(2, is_integer64(aR) || is_integer64(MR)));
+  set_int64(output, 0, m / a);
+  set_int64(output, 1, m % a);
+
+  SEXP nms = PROTECT(Rf_allocVector(STRSXP, 2));
+  Rf_namesgets(output, nms);
+  SET_STRING_ELT(nms, 0, mkChar("q"));
+  SET_STRING_ELT(nms, 1, mkChar("r"));
+
+  UNPROTECT(2);
+  return output;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   64-bit integers from R
+-------------------------------------------------------------------------------- */
+
+/* largest double below which every integer is exact */
+#define INT64_DOUBLE_MAX 9007199254740992.0
+
+int is_integer64(SEXP x){
+  return Rf_inherits(x, "integer64");
+};
+
+int64_t get_int64(SEXP x, R_xlen_t i){
+  if(is_integer64(x)){
+    int64_t v;
+    memcpy(&v, &REAL(x)[i], sizeof(int64_t));
+    return v;
+  }
+  double d = REAL(x)[i];
+  if(ISNAN(d) || d != floor(d) || fabs(d) > INT64_DOUBLE_MAX){
+    return INT64_NA;
+  }
+  return (int64_t)d;
+};
+
+void set_int64(SEXP x, R_xlen_t i, int64_t v){
+  if(is_integer64(x)){
+    memcpy(&REAL(x)[i], &v, sizeof(int64_t));
+  } else {
+    REAL(x)[i] = (v == INT64_NA) ? NA_REAL : (double)v;
+  }
+};
+
+SEXP alloc_int64(R_xlen_t n, int bit64){
+  SEXP x = PROTECT(Rf_allocVector(REALSXP, n));
+  if(bit64){
+    Rf_setAttrib(x, R_ClassSymbol, Rf_mkString("integer64"));
+  }
+  UNPROTECT(1);
+  return x;
+};
+
+int64_t as_int64(SEXP x, const char* name){
+  if(TYPEOF(x) != REALSXP || XLENGTH(x) < 1){
+    Rf_error("'%s' should be a double or integer64", name);
+  }
+  int64_t v = get_int64(x, 0);
+  if(v == INT64_NA){
+    Rf_error("'%s' should be a whole number of magnitude at most 2^53 (or an integer64)", name);
+  }
+  return v;
+};
@@ -12,6 +12,8 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
 
 #include <R.h>
 #include <Rinternals.h>
@@ -26,11 +28,34 @@ SEXP gcd_C(SEXP aR, SEXP bR);
 
 int gcd(int a, int b);
 
-SEXP sieve_C(SEXP NR);
+SEXP sieve_C(SEXP NR, SEXP loR, SEXP countR, SEXP threadsR);
 
 SEXP approx_factor_C(SEXP aR, SEXP MR);
 
 int* approx_factor(const int a, const int M);
 
+SEXP approx_factor_64_C(SEXP aR, SEXP MR);
+
+
+/* --------------------------------------------------------------------------------
+#   64-bit integers from R: doubles holding whole numbers up to 2^53, or bit64 'integer64'
+#   vectors (the int64 bits stored in a double vector)
+-------------------------------------------------------------------------------- */
+
+/* NA of integer64 */
+#define INT64_NA INT64_MIN
+
+int is_integer64(SEXP x);
+
+int64_t get_int64(SEXP x, R_xlen_t i);
+
+void set_int64(SEXP x, R_xlen_t i, int64_t v);
+
+/* allocate (unprotected) an integer64 vector if bit64, otherwise a double vector */
+SEXP alloc_int64(R_xlen_t n, int bit64);
+
+/* first element as a non-NA int64, or an error naming the argument */
+int64_t as_int64(SEXP x, const char* name);
+
 
 #endif
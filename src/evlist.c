@@ -0,0 +1,330 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Future event lists: d-ary heap and calendar queue
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "evlist.h"
+
+
+/* --------------------------------------------------------------------------------
+#   d-ary heap
+-------------------------------------------------------------------------------- */
+
+int init_event_heap(event_heap* h, size_t capacity){
+  if(capacity < 16){
+    capacity = 16;
+  }
+  h->ev = (event*)malloc(capacity * sizeof(event));
+  h->size = 0;
+  h->capacity = (h->ev != NULL) ? capacity : 0;
+  h->seq = 0;
+  return h->ev != NULL;
+};
+
+int push_event_heap(event_heap* h, double time, int type, int id){
+  event e = {time, h->seq, type, id};
+  if(!insert_event_heap(h, e)){
+    return 0;
+  }
+  h->seq++;
+  return 1;
+};
+
+int insert_event_heap(event_heap* h, event e){
+
+  if(h->size == h->capacity){
+    size_t capacity = (h->capacity > 0) ? 2 * h->capacity : 16;
+    event* ev = (event*)realloc(h->ev, capacity * sizeof(event));
+    if(ev == NULL){
+      return 0;
+    }
+    h->ev = ev;
+    h->capacity = capacity;
+  }
+
+  /* sift up: move parents down until e fits */
+  size_t i = h->size++;
+  while(i > 0){
+    size_t parent = (i - 1) / EVHEAP_D;
+    if(!event_before(&e, &h->ev[parent])){
+      break;
+    }
+    h->ev[i] = h->ev[parent];
+    i = parent;
+  }
+  h->ev[i] = e;
+  return 1;
+};
+
+event pop_event_heap(event_heap* h){
+
+  event top = h->ev[0];
+  event e = h->ev[--h->size];
+  size_t n = h->size;
+
+  /* sift down: move the smallest child up until e fits */
+  size_t i = 0;
+  for(;;){
+    size_t first = EVHEAP_D * i + 1;
+    if(first >= n){
+      break;
+    }
+    size_t last = (first + EVHEAP_D < n) ? first + EVHEAP_D : n;
+    size_t best = first;
+    for(size_t c=first+1; c<last; c++){
+      if(event_before(&h->ev[c], &h->ev[best])){
+        best = c;
+      }
+    }
+    if(!event_before(&h->ev[best], &e)){
+      break;
+    }
+    h->ev[i] = h->ev[best];
+    i = best;
+  }
+  if(n > 0){
+    h->ev[i] = e;
+  }
+
+  return top;
+};
+
+const event* peek_event_heap(const event_heap* h){
+  return (h->size > 0) ? &h->ev[0] : NULL;
+};
+
+void free_event_heap(event_heap* h){
+  free(h->ev);
+  h->ev = NULL;
+  h->size = 0;
+  h->capacity = 0;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   calendar queue: node pool
+-------------------------------------------------------------------------------- */
+
+#define CQ_CHUNK 1024
+
+/* a node from the pool, or NULL if out of memory */
+static cq_node* cq_alloc(calendar_queue* q){
+  if(q->free_nodes == NULL){
+    cq_chunk* chunk = (cq_chunk*)malloc(sizeof(cq_chunk) + CQ_CHUNK * sizeof(cq_node));
+    if(chunk == NULL){
+      return NULL;
+    }
+    chunk->next = q->chunks;
+    q->chunks = chunk;
+    for(size_t i=0; i<CQ_CHUNK; i++){
+      chunk->node[i].next = q->free_nodes;
+      q->free_nodes = &chunk->node[i];
+    }
+  }
+  cq_node* node = q->free_nodes;
+  q->free_nodes = node->next;
+  return node;
+};
+
+static void cq_release(calendar_queue* q, cq_node* node){
+  node->next = q->free_nodes;
+  q->free_nodes = node;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   calendar queue: bucket management
+-------------------------------------------------------------------------------- */
+
+/* the day of an event; every comparison against the current day goes through here so rounding is consistent */
+static uint64_t cq_day(const calendar_queue* q, double time){
+  return (uint64_t)(time / q->width);
+};
+
+static size_t cq_index(const calendar_queue* q, double time){
+  return (size_t)(cq_day(q, time) % (uint64_t)q->nbuckets);
+};
+
+/* insert an existing node into its bucket, keeping the bucket sorted */
+static void cq_insert(calendar_queue* q, cq_node* node){
+  cq_node** p = &q->bucket[cq_index(q, node->ev.time)];
+  while(*p != NULL && event_before(&(*p)->ev, &node->ev)){
+    p = &(*p)->next;
+  }
+  node->next = *p;
+  *p = node;
+  q->size++;
+};
+
+/* set up nbuckets empty buckets of the given width, with the current day starting at start;
+   returns 0 (leaving q as it was) if out of memory */
+static int cq_local_init(calendar_queue* q, size_t nbuckets, double width, double start){
+  cq_node** bucket = (cq_node**)calloc(nbuckets, sizeof(cq_node*));
+  if(bucket == NULL){
+    return 0;
+  }
+  q->bucket = bucket;
+  q->nbuckets = nbuckets;
+  q->width = width;
+  q->size = 0;
+  q->last_time = start;
+  q->day = cq_day(q, start);
+  return 1;
+};
+
+static event cq_dequeue(calendar_queue* q);
+
+/* estimate a bucket width from the separation of the most imminent events */
+static double cq_new_width(calendar_queue* q){
+
+  size_t nsample = (q->size < 25) ? q->size : 25;
+  if(nsample < 2){
+    return q->width;
+  }
+
+  /* take the first events off the queue, then put them back (into the nodes just released) */
+  cq_node* sample[25];
+  q->resize_ok = 0;
+  double last_time = q->last_time;
+  uint64_t day = q->day;
+  for(size_t i=0; i<nsample; i++){
+    event e = cq_dequeue(q);
+    sample[i] = cq_alloc(q);
+    sample[i]->ev = e;
+  }
+  for(size_t i=0; i<nsample; i++){
+    cq_insert(q, sample[i]);
+  }
+  q->last_time = last_time;
+  q->day = day;
+  q->resize_ok = 1;
+
+  /* average separation, then again ignoring large gaps */
+  double total = sample[nsample-1]->ev.time - sample[0]->ev.time;
+  double avg = total / (double)(nsample - 1);
+  double sum = 0.;
+  size_t k = 0;
+  for(size_t i=1; i<nsample; i++){
+    double gap = sample[i]->ev.time - sample[i-1]->ev.time;
+    if(gap <= 2. * avg){
+      sum += gap;
+      k++;
+    }
+  }
+  if(k == 0 || sum <= 0.){
+    return q->width;
+  }
+  return 3. * sum / (double)k;
+};
+
+static void cq_resize(calendar_queue* q, size_t nbuckets){
+
+  double width = cq_new_width(q);
+
+  cq_node** old = q->bucket;
+  size_t old_n = q->nbuckets;
+
+  /* out of memory: carry on with the old buckets */
+  if(!cq_local_init(q, nbuckets, width, q->last_time)){
+    return;
+  }
+
+  for(size_t i=0; i<old_n; i++){
+    cq_node* node = old[i];
+    while(node != NULL){
+      cq_node* next = node->next;
+      cq_insert(q, node);
+      node = next;
+    }
+  }
+  free(old);
+};
+
+static event cq_dequeue(calendar_queue* q){
+
+  uint64_t day = q->day;
+
+  /* scan a year of buckets for an event in the current day */
+  for(size_t n=0; n<q->nbuckets; n++){
+    size_t i = (size_t)(day % (uint64_t)q->nbuckets);
+    cq_node* node = q->bucket[i];
+    if(node != NULL && cq_day(q, node->ev.time) <= day){
+      event e = node->ev;
+      q->bucket[i] = node->next;
+      cq_release(q, node);
+      q->size--;
+      q->day = day;
+      q->last_time = e.time;
+      return e;
+    }
+    day++;
+  }
+
+  /* nothing within a year: direct search for the minimum over the bucket heads */
+  size_t best = q->nbuckets;
+  for(size_t j=0; j<q->nbuckets; j++){
+    if(q->bucket[j] != NULL && (best == q->nbuckets || event_before(&q->bucket[j]->ev, &q->bucket[best]->ev))){
+      best = j;
+    }
+  }
+  cq_node* node = q->bucket[best];
+  event e = node->ev;
+  q->bucket[best] = node->next;
+  cq_release(q, node);
+  q->size--;
+  q->day = cq_day(q, e.time);
+  q->last_time = e.time;
+  return e;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   calendar queue: public interface
+-------------------------------------------------------------------------------- */
+
+int init_calendar_queue(calendar_queue* q){
+  q->free_nodes = NULL;
+  q->chunks = NULL;
+  q->bucket = NULL;
+  q->seq = 0;
+  q->resize_ok = 1;
+  return cq_local_init(q, 2, 1., 0.);
+};
+
+int push_calendar_queue(calendar_queue* q, double time, int type, int id){
+  cq_node* node = cq_alloc(q);
+  if(node == NULL){
+    return 0;
+  }
+  event e = {time, q->seq++, type, id};
+  node->ev = e;
+  cq_insert(q, node);
+  if(q->resize_ok && q->size > 2 * q->nbuckets){
+    cq_resize(q, 2 * q->nbuckets);
+  }
+  return 1;
+};
+
+event pop_calendar_queue(calendar_queue* q){
+  event e = cq_dequeue(q);
+  if(q->resize_ok && q->nbuckets > 2 && q->size < q->nbuckets / 2){
+    cq_resize(q, q->nbuckets / 2);
+  }
+  return e;
+};
+
+void free_calendar_queue(calendar_queue* q){
+  free(q->bucket);
+  q->bucket = NULL;
+  while(q->chunks != NULL){
+    cq_chunk* next = q->chunks->next;
+    free(q->chunks);
+    q->chunks = next;
+  }
+  q->free_nodes = NULL;
+  q->size = 0;
+};
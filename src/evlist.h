@@ -0,0 +1,110 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Future event lists: d-ary heap and calendar queue
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef EVLIST_H
+#define EVLIST_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+
+/* --------------------------------------------------------------------------------
+#   an event: ties in time are broken by insertion order (first scheduled, first out)
+-------------------------------------------------------------------------------- */
+
+typedef struct event {
+  double   time; /* event time                               */
+  uint64_t seq;  /* insertion counter, used to break ties    */
+  int      type; /* event type (arrival, departure, ...)     */
+  int      id;   /* payload, e.g. server or job index        */
+} event;
+
+/* 1 if a should come out of the list before b */
+static inline int event_before(const event* a, const event* b){
+  return (a->time < b->time) || (a->time == b->time && a->seq < b->seq);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   array-backed d-ary heap: O(log n) insert and extract-min
+-------------------------------------------------------------------------------- */
+
+#define EVHEAP_D 4
+
+typedef struct event_heap {
+  event*   ev;       /* ev[0] is the most imminent event */
+  size_t   size;
+  size_t   capacity;
+  uint64_t seq;
+} event_heap;
+
+/* initialize an empty heap with room for capacity events (grows as needed); returns 1 on success, 0 if out of memory */
+int init_event_heap(event_heap* h, size_t capacity);
+
+/* schedule an event; returns 1 on success, 0 if out of memory */
+int push_event_heap(event_heap* h, double time, int type, int id);
+
+/* schedule an event whose tie-breaking seq is chosen by the caller (e.g. a job or server index),
+   for keyed heaps that order on (key, index); h->seq is not advanced */
+int insert_event_heap(event_heap* h, event e);
+
+/* remove and return the most imminent event (the heap must not be empty) */
+event pop_event_heap(event_heap* h);
+
+/* the most imminent event, or NULL if empty */
+const event* peek_event_heap(const event_heap* h);
+
+/* free the heap */
+void free_event_heap(event_heap* h);
+
+
+/* --------------------------------------------------------------------------------
+#   calendar queue (Brown 1988): amortized O(1) insert and extract-min
+#   nodes come from a pool that is allocated in chunks and never returned to malloc
+#   until the queue is freed; as in any next-event simulation, events must not be
+#   scheduled earlier than the last event taken off the queue
+-------------------------------------------------------------------------------- */
+
+typedef struct cq_node {
+  event           ev;
+  struct cq_node* next;
+} cq_node;
+
+typedef struct cq_chunk {
+  struct cq_chunk* next;
+  cq_node          node[];
+} cq_chunk;
+
+typedef struct calendar_queue {
+  cq_node** bucket;      /* each bucket is a list sorted by (time, seq) */
+  size_t    nbuckets;
+  double    width;       /* bucket width (a "day")                     */
+  size_t    size;
+  uint64_t  day;         /* day of the last dequeued event, time/width */
+  double    last_time;   /* time of the last dequeued event            */
+  int       resize_ok;   /* resizing is disabled while sampling        */
+  uint64_t  seq;
+  cq_node*  free_nodes;  /* node pool                                  */
+  cq_chunk* chunks;
+} calendar_queue;
+
+/* initialize an empty calendar queue; returns 1 on success, 0 if out of memory */
+int init_calendar_queue(calendar_queue* q);
+
+/* schedule an event; returns 1 on success, 0 if out of memory */
+int push_calendar_queue(calendar_queue* q, double time, int type, int id);
+
+/* remove and return the most imminent event (the queue must not be empty) */
+event pop_calendar_queue(calendar_queue* q);
+
+/* free the queue and its node pool */
+void free_calendar_queue(calendar_queue* q);
+
+#endif
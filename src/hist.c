@@ -0,0 +1,198 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Streaming histograms for discrete and continuous data
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "hist.h"
+
+/* values binned at once: indices are computed for a whole block (no dependencies, vectorizes), then counted */
+#define HIST_BLOCK 256
+
+int hist_init_discrete(hist* h, int a, int b){
+  h->type = HIST_DISCRETE;
+  h->k = b - a + 1;
+  h->a = a;
+  h->lo = a;
+  h->hi = (double)b + 1.;
+  h->delta = 1.;
+  h->count = (int64_t*)calloc((size_t)h->k + 3, sizeof(int64_t));
+  return h->count != NULL;
+};
+
+int hist_init_continuous(hist* h, double lo, double hi, int k){
+  h->type = HIST_CONTINUOUS;
+  h->k = k;
+  h->a = 0;
+  h->lo = lo;
+  h->hi = hi;
+  h->delta = (hi - lo) / (double)k;
+  h->count = (int64_t*)calloc((size_t)k + 3, sizeof(int64_t));
+  return h->count != NULL;
+};
+
+void hist_free(hist* h){
+  free(h->count);
+  h->count = NULL;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   binning a chunk into a count array
+-------------------------------------------------------------------------------- */
+
+/* bin index of one value; written without branches so a block of them vectorizes */
+static inline int bin_index_int(const int x, const unsigned int a, const unsigned int k){
+  unsigned int u = (unsigned int)x - a;    /* x - a for x >= a, wraps around otherwise */
+  int j = (u < k) ? (int)u + 1 : (int)k + 1;
+  j = (x < (int)a) ? 0 : j;
+  j = (x == HIST_NA_INT) ? (int)k + 2 : j;
+  return j;
+};
+
+static inline int bin_index_double(const double x, const double lo, const double hi, const double inv, const int k){
+  /* clamp before converting so the cast is always defined; rounding can put x < hi into bin k */
+  double t = (x - lo) * inv;
+  t = (t > 0.) ? t : 0.;
+  t = (t < (double)(k - 1)) ? t : (double)(k - 1);
+  int j = (int)t + 1;
+  j = (x < lo) ? 0 : j;
+  j = (x >= hi) ? k + 1 : j;
+  j = (x != x) ? k + 2 : j;
+  return j;
+};
+
+static void bin_int(const hist* h, const int* x, size_t n, int64_t* count){
+  const unsigned int k = (unsigned int)h->k;
+  const unsigned int a = (unsigned int)h->a;
+  int idx[HIST_BLOCK];
+
+  size_t i = 0;
+  for(; i+HIST_BLOCK<=n; i+=HIST_BLOCK){
+    for(int l=0; l<HIST_BLOCK; l++){
+      idx[l] = bin_index_int(x[i+l], a, k);
+    }
+    for(int l=0; l<HIST_BLOCK; l++){
+      count[idx[l]]++;
+    }
+  }
+  for(; i<n; i++){
+    count[bin_index_int(x[i], a, k)]++;
+  }
+};
+
+static void bin_double(const hist* h, const double* x, size_t n, int64_t* count){
+  const int k = h->k;
+  const double lo = h->lo;
+  const double hi = h->hi;
+  const double inv = 1. / h->delta;
+  int idx[HIST_BLOCK];
+
+  size_t i = 0;
+  for(; i+HIST_BLOCK<=n; i+=HIST_BLOCK){
+    for(int l=0; l<HIST_BLOCK; l++){
+      idx[l] = bin_index_double(x[i+l], lo, hi, inv, k);
+    }
+    for(int l=0; l<HIST_BLOCK; l++){
+      count[idx[l]]++;
+    }
+  }
+  for(; i<n; i++){
+    count[bin_index_double(x[i], lo, hi, inv, k)]++;
+  }
+};
+
+/* each thread bins a contiguous chunk into private counts, which are then added up */
+static void hist_add(hist* h, const void* x, size_t n, int threads, int is_int){
+
+  const size_t nc = (size_t)h->k + 3;
+
+  /* private counts for every thread (nc * threads can be large); counts are exact, so if they
+     cannot be allocated the serial path gives the same result */
+  int64_t* part = NULL;
+  if(threads > 1 && n >= (size_t)threads * 4096){
+    part = (int64_t*)calloc(nc * threads, sizeof(int64_t));
+  }
+
+  if(part == NULL){
+    if(is_int){
+      bin_int(h, (const int*)x, n, h->count);
+    } else {
+      bin_double(h, (const double*)x, n, h->count);
+    }
+    return;
+  }
+
+  size_t chunk = (n + threads - 1) / threads;
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(threads) schedule(static, 1)
+#endif
+  for(int t=0; t<threads; t++){
+    size_t from = (size_t)t * chunk;
+    size_t to = (from + chunk < n) ? from + chunk : n;
+    if(from < to){
+      if(is_int){
+        bin_int(h, (const int*)x + from, to - from, part + nc * t);
+      } else {
+        bin_double(h, (const double*)x + from, to - from, part + nc * t);
+      }
+    }
+  }
+
+  for(int t=0; t<threads; t++){
+    for(size_t j=0; j<nc; j++){
+      h->count[j] += part[nc * t + j];
+    }
+  }
+  free(part);
+};
+
+void hist_add_int(hist* h, const int* x, size_t n, int threads){
+  hist_add(h, x, n, threads, 1);
+};
+
+void hist_add_double(hist* h, const double* x, size_t n, int threads){
+  hist_add(h, x, n, threads, 0);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   combining and summarising
+-------------------------------------------------------------------------------- */
+
+int hist_compatible(const hist* a, const hist* b){
+  return a->type == b->type && a->k == b->k && a->a == b->a && a->lo == b->lo && a->hi == b->hi;
+};
+
+void hist_merge(hist* a, const hist* b){
+  for(int j=0; j<a->k+3; j++){
+    a->count[j] += b->count[j];
+  }
+};
+
+void hist_moments(const hist* h, double* xbar, double* s){
+  double n = 0., sum = 0.;
+  for(int j=0; j<h->k; j++){
+    double x = h->lo + ((double)j + ((h->type == HIST_CONTINUOUS) ? 0.5 : 0.)) * h->delta;
+    n += (double)h->count[j+1];
+    sum += x * (double)h->count[j+1];
+  }
+  if(n == 0.){
+    *xbar = NAN;
+    *s = NAN;
+    return;
+  }
+  *xbar = sum / n;
+
+  /* two passes over the bins, so no cancellation */
+  double v = 0.;
+  for(int j=0; j<h->k; j++){
+    double x = h->lo + ((double)j + ((h->type == HIST_CONTINUOUS) ? 0.5 : 0.)) * h->delta;
+    v += (x - *xbar) * (x - *xbar) * (double)h->count[j+1];
+  }
+  *s = sqrt(v / n);
+};
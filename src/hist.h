@@ -0,0 +1,65 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Streaming histograms for discrete and continuous data
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef HIST_H
+#define HIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+/* --------------------------------------------------------------------------------
+#   histogram with k bins
+#   discrete (algorithm 4.2.1): bin j counts the integer a + j, j = 0,...,k-1 (k = b - a + 1)
+#   continuous (section 4.3):   bin j counts [lo + j*delta, lo + (j+1)*delta), delta = (hi - lo)/k
+#   count[0] is below the range, count[1..k] the bins, count[k+1] above the range and
+#   count[k+2] the missing values
+-------------------------------------------------------------------------------- */
+
+#define HIST_DISCRETE   0
+#define HIST_CONTINUOUS 1
+
+/* R's NA_integer_ */
+#define HIST_NA_INT INT32_MIN
+
+typedef struct hist {
+  int      type;
+  int      k;       /* number of bins                    */
+  int      a;       /* discrete: value of the first bin  */
+  double   lo;      /* continuous: range [lo, hi)        */
+  double   hi;
+  double   delta;   /* continuous: bin width             */
+  int64_t* count;   /* k + 3 counts, see above           */
+} hist;
+
+/* return 0 if the counts could not be allocated */
+int hist_init_discrete(hist* h, int a, int b);
+
+int hist_init_continuous(hist* h, double lo, double hi, int k);
+
+void hist_free(hist* h);
+
+/* add x[0,...,n-1]; with threads > 1 (and OpenMP) each thread counts a chunk into private counts */
+void hist_add_int(hist* h, const int* x, size_t n, int threads);
+
+void hist_add_double(hist* h, const double* x, size_t n, int threads);
+
+/* 1 if a and b have the same bins */
+int hist_compatible(const hist* a, const hist* b);
+
+/* add the counts of b to a (which must be compatible) */
+void hist_merge(hist* a, const hist* b);
+
+/* mean and standard deviation of the data in range, taking every value in a continuous bin to be its midpoint */
+void hist_moments(const hist* h, double* xbar, double* s);
+
+#endif
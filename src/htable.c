@@ -0,0 +1,129 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Open-addressing hash table
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "htable.h"
+
+
+/* --------------------------------------------------------------------------------
+#   Fibonacci hashing: multiply by 2^64/phi and keep the top bits
+-------------------------------------------------------------------------------- */
+
+static inline size_t hash_int(int key, int bits){
+  return (size_t)(((uint64_t)(uint32_t)key * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+};
+
+static int alloc_int_htable(int_htable* table, int bits){
+  table->bits = bits;
+  table->capacity = (size_t)1 << bits;
+  table->size = 0;
+  table->key = (int*)malloc(table->capacity * sizeof(int));
+  table->value = (int64_t*)malloc(table->capacity * sizeof(int64_t));
+  table->used = (unsigned char*)calloc(table->capacity, sizeof(unsigned char));
+  if(table->key == NULL || table->value == NULL || table->used == NULL){
+    free_int_htable(table);
+    table->capacity = 0;
+    return 0;
+  }
+  return 1;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   initialize the table
+-------------------------------------------------------------------------------- */
+
+int init_int_htable(int_htable* table, size_t n){
+  int bits = 4;
+  while(((size_t)1 << bits) < 2 * n){
+    bits++;
+  }
+  return alloc_int_htable(table, bits);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   double the capacity and reinsert every key; if the larger table cannot be allocated the old one is kept
+-------------------------------------------------------------------------------- */
+
+static int grow_int_htable(int_htable* table){
+
+  int_htable old = *table;
+  if(!alloc_int_htable(table, old.bits + 1)){
+    *table = old;
+    return 0;
+  }
+
+  int64_t found;
+  for(size_t i=0; i<old.capacity; i++){
+    if(old.used[i]){
+      insert_int_htable(table, old.key[i], old.value[i], &found);
+    }
+  }
+
+  free_int_htable(&old);
+  return 1;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   insert and lookup
+-------------------------------------------------------------------------------- */
+
+int insert_int_htable(int_htable* table, int key, int64_t value, int64_t* found){
+
+  /* keep the load factor at or below 1/2 */
+  if(2 * (table->size + 1) > table->capacity && !grow_int_htable(table)){
+    return 0;
+  }
+
+  size_t mask = table->capacity - 1;
+  size_t i = hash_int(key, table->bits);
+  while(table->used[i]){
+    if(table->key[i] == key){
+      *found = table->value[i];
+      return 1;
+    }
+    i = (i + 1) & mask;
+  }
+
+  table->used[i] = 1;
+  table->key[i] = key;
+  table->value[i] = value;
+  table->size++;
+  *found = -1;
+  return 1;
+};
+
+int64_t find_int_htable(const int_htable* table, int key){
+
+  size_t mask = table->capacity - 1;
+  size_t i = hash_int(key, table->bits);
+  while(table->used[i]){
+    if(table->key[i] == key){
+      return table->value[i];
+    }
+    i = (i + 1) & mask;
+  }
+  return -1;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   free the table
+-------------------------------------------------------------------------------- */
+
+void free_int_htable(int_htable* table){
+  free(table->key);
+  free(table->value);
+  free(table->used);
+  table->key = NULL;
+  table->value = NULL;
+  table->used = NULL;
+  table->size = 0;
+};
@@ -0,0 +1,42 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Open-addressing hash table
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef HTABLE_H
+#define HTABLE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+/* --------------------------------------------------------------------------------
+#   hash table from int keys to non-negative 64-bit values (linear probing)
+-------------------------------------------------------------------------------- */
+
+typedef struct _int_htable {
+  int*           key;
+  int64_t*       value;
+  unsigned char* used;
+  size_t         size;
+  size_t         capacity; /* a power of 2 */
+  int            bits;     /* log2(capacity) */
+} int_htable ;
+
+/* initialize the table with room for about n keys (grows as needed); returns 1 on success, 0 if out of memory */
+int init_int_htable(int_htable* table, size_t n);
+
+/* insert key with value if absent and set *found to -1; if present, leave it and set *found to its value;
+   returns 1 on success, 0 if out of memory (the table is left as it was) */
+int insert_int_htable(int_htable* table, int key, int64_t value, int64_t* found);
+
+/* value stored for key, or -1 if absent */
+int64_t find_int_htable(const int_htable* table, int key);
+
+/* free the table */
+void free_int_htable(int_htable* table);
+
+#endif
@@ -0,0 +1,41 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Package initialization
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include <R.h>
+#include <Rinternals.h>
+#include <R_ext/Rdynload.h>
+
+#include "trans.h"
+
+
+/* --------------------------------------------------------------------------------
+#   the book's middle-square examples as native transition functions
+-------------------------------------------------------------------------------- */
+
+/* g(x) = floor(x^2 / 100) mod 10000 */
+static int midsq4(int x){
+  return (int)(((int64_t)x * x / 100) % 10000);
+};
+
+/* g(x) = floor(x^2 / 1000) mod 1000000 */
+static int midsq6(int x){
+  return (int)(((int64_t)x * x / 1000) % 1000000);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   called by R when the package is loaded
+#   .Call entry points are still found by name (NAMESPACE useDynLib), so only
+#   functions callable from other packages' C code are registered here
+-------------------------------------------------------------------------------- */
+
+void R_init_desr(DllInfo* dll){
+  R_RegisterCCallable("desr", "midsq4", (DL_FUNC)midsq4);
+  R_RegisterCCallable("desr", "midsq6", (DL_FUNC)midsq6);
+};
@@ -0,0 +1,113 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Queues of waiting jobs under different queue disciplines
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "jobqueue.h"
+
+
+/* --------------------------------------------------------------------------------
+#   storage
+-------------------------------------------------------------------------------- */
+
+static int is_heap(const jobqueue* q){
+  return q->discipline == JQ_SJF || q->discipline == JQ_PRIORITY;
+};
+
+int jq_init(jobqueue* q, int discipline, size_t capacity){
+  q->discipline = discipline;
+  q->size = 0;
+  q->head = 0;
+  q->cap = 16;
+  while(q->cap < capacity){
+    q->cap *= 2;
+  }
+  q->ring = NULL;
+  q->heap.ev = NULL;
+  q->heap.size = 0;
+  q->heap.capacity = 0;
+  if(is_heap(q)){
+    return init_event_heap(&q->heap, q->cap);
+  }
+  q->ring = (int64_t*)malloc(sizeof(int64_t) * q->cap);
+  return q->ring != NULL;
+};
+
+void jq_free(jobqueue* q){
+  free(q->ring);
+  free_event_heap(&q->heap);
+  q->ring = NULL;
+};
+
+/* double the capacity of the ring, unrolled so the oldest job is at 0 again */
+static int jq_grow(jobqueue* q){
+  size_t cap = 2 * q->cap;
+  int64_t* ring = (int64_t*)malloc(sizeof(int64_t) * cap);
+  if(ring == NULL){
+    return 0;
+  }
+  for(size_t k=0; k<q->size; k++){
+    ring[k] = q->ring[(q->head + k) & (q->cap - 1)];
+  }
+  free(q->ring);
+  q->ring = ring;
+  q->head = 0;
+  q->cap = cap;
+  return 1;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   push and pop
+-------------------------------------------------------------------------------- */
+
+int jq_push(jobqueue* q, int64_t job, double key){
+  if(is_heap(q)){
+    event e = {key, (uint64_t)job, 0, 0};
+    if(!insert_event_heap(&q->heap, e)){
+      return 0;
+    }
+    q->size++;
+  } else {
+    if(q->size == q->cap && !jq_grow(q)){
+      return 0;
+    }
+    q->ring[(q->head + q->size) & (q->cap - 1)] = job;
+    q->size++;
+  }
+  return 1;
+};
+
+int64_t jq_pop(jobqueue* q, rngs* r){
+  const size_t mask = q->cap - 1;
+  int64_t job;
+  switch(q->discipline){
+    case JQ_LIFO:
+      q->size--;
+      return q->ring[(q->head + q->size) & mask];
+    case JQ_SIRO: {
+      /* swap a job chosen at random to the front, then serve the front */
+      size_t k = (size_t)rngs_equilikely(r, 0, (long)q->size - 1);
+      size_t front = q->head;
+      size_t pick = (q->head + k) & mask;
+      job = q->ring[pick];
+      q->ring[pick] = q->ring[front];
+      q->head = (q->head + 1) & mask;
+      q->size--;
+      return job;
+    }
+    case JQ_SJF:
+    case JQ_PRIORITY:
+      q->size--;
+      return (int64_t)pop_event_heap(&q->heap).seq;
+    default:
+      job = q->ring[q->head];
+      q->head = (q->head + 1) & mask;
+      q->size--;
+      return job;
+  }
+};
@@ -0,0 +1,52 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Queues of waiting jobs under different queue disciplines
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef JOBQUEUE_H
+#define JOBQUEUE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "rng.h"
+#include "evlist.h"
+
+
+/* --------------------------------------------------------------------------------
+#   queue disciplines: FIFO, LIFO and SIRO keep jobs in a growable ring buffer (O(1) per job),
+#   SJF and priority in an event heap (evlist.h) on (key, job) (O(log n) per job), so equal
+#   keys are served in order of arrival
+-------------------------------------------------------------------------------- */
+
+#define JQ_FIFO     0 /* first in, first out                         */
+#define JQ_LIFO     1 /* last in, first out                          */
+#define JQ_SIRO     2 /* service in random order                     */
+#define JQ_SJF      3 /* shortest job (service time) first           */
+#define JQ_PRIORITY 4 /* lowest priority value first                 */
+
+typedef struct jobqueue {
+  int      discipline;
+  size_t   size;
+  size_t   cap;
+  size_t   head;  /* ring buffer: index of the oldest job, cap is a power of 2 */
+  int64_t*   ring;
+  event_heap heap;  /* SJF and priority: the key is the time and the job the seq */
+} jobqueue;
+
+/* empty queue with room for capacity jobs (grows as needed); returns 1 on success, 0 if out of memory */
+int jq_init(jobqueue* q, int discipline, size_t capacity);
+
+void jq_free(jobqueue* q);
+
+/* add job (with key, used by JQ_SJF and JQ_PRIORITY); returns 1 on success, 0 if out of memory */
+int jq_push(jobqueue* q, int64_t job, double key);
+
+/* remove and return the next job to serve (the queue must not be empty); r is used by JQ_SIRO */
+int64_t jq_pop(jobqueue* q, rngs* r);
+
+#endif
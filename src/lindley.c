@@ -0,0 +1,87 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Delay recursion of a single-server FIFO service node (algorithm 1.2.1)
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "lindley.h"
+
+
+/* --------------------------------------------------------------------------------
+#   one trace
+-------------------------------------------------------------------------------- */
+
+double lindley(const double* a, const double* s, double* d, size_t n, double c){
+  for(size_t i=0; i<n; i++){
+    double a_i = a[i];
+    double d_i = (a_i < c) ? c - a_i : 0.;
+    d[i] = d_i;
+    c = a_i + d_i + s[i];
+  }
+  return c;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   LINDLEY_LANES traces at once: each tile of rows is transposed so the lanes of a row are
+#   contiguous, the recursion then advances every lane with the same vector instructions
+#   (no loop-carried dependency between lanes), and the delays are transposed back
+-------------------------------------------------------------------------------- */
+
+static void lindley_lanes(const double* a, size_t as, const double* s, size_t ss, double* d, size_t n){
+
+  double c[LINDLEY_LANES] = {0.};
+  double ta[LINDLEY_TILE][LINDLEY_LANES];
+  double ts[LINDLEY_TILE][LINDLEY_LANES];
+  double td[LINDLEY_TILE][LINDLEY_LANES];
+
+  for(size_t i0=0; i0<n; i0+=LINDLEY_TILE){
+    size_t rows = (n - i0 < LINDLEY_TILE) ? n - i0 : LINDLEY_TILE;
+
+    for(int l=0; l<LINDLEY_LANES; l++){
+      const double* al = a + i0 + as * l;
+      const double* sl = s + i0 + ss * l;
+      for(size_t i=0; i<rows; i++){
+        ta[i][l] = al[i];
+        ts[i][l] = sl[i];
+      }
+    }
+
+    for(size_t i=0; i<rows; i++){
+      for(int l=0; l<LINDLEY_LANES; l++){
+        double d_i = c[l] - ta[i][l];
+        d_i = (d_i > 0.) ? d_i : 0.;
+        td[i][l] = d_i;
+        c[l] = ta[i][l] + d_i + ts[i][l];
+      }
+    }
+
+    for(int l=0; l<LINDLEY_LANES; l++){
+      double* dl = d + i0 + n * l;
+      for(size_t i=0; i<rows; i++){
+        dl[i] = td[i][l];
+      }
+    }
+  }
+};
+
+void lindley_traces(const double* a, size_t as, const double* s, size_t ss, double* d, size_t n, size_t m, int threads){
+
+  /* full blocks of lanes, then the remaining traces one at a time */
+  long blocks = (long)(m / LINDLEY_LANES);
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+  for(long b=0; b<blocks; b++){
+    size_t j = (size_t)b * LINDLEY_LANES;
+    lindley_lanes(a + as * j, as, s + ss * j, ss, d + n * j, n);
+  }
+
+  for(size_t j=(size_t)blocks * LINDLEY_LANES; j<m; j++){
+    lindley(a + as * j, s + ss * j, d + n * j, n, 0.);
+  }
+};
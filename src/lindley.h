@@ -0,0 +1,35 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Delay recursion of a single-server FIFO service node (algorithm 1.2.1)
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef LINDLEY_H
+#define LINDLEY_H
+
+#include <stddef.h>
+
+
+/* --------------------------------------------------------------------------------
+#   d_i = max(0, c_{i-1} - a_i), c_i = a_i + d_i + s_i; all kernels give bitwise the same
+#   delays as algorithm 1.2.1
+-------------------------------------------------------------------------------- */
+
+/* number of traces advanced together by lindley_traces */
+#define LINDLEY_LANES 8
+
+/* rows of each trace transposed into lane order at a time (3 tiles of 4 KB) */
+#define LINDLEY_TILE 64
+
+/* one trace: delays of jobs 0,...,n-1 into d given the departure time c of the previous job; returns the last departure */
+double lindley(const double* a, const double* s, double* d, size_t n, double c);
+
+/* m traces with an initially idle server: job i of trace j arrives at a[i + as*j], needs s[i + ss*j] and
+   is delayed d[i + n*j]; as (ss) is n for a matrix of traces or 0 to share one column across all traces;
+   blocks of LINDLEY_LANES traces are split across threads (if built with OpenMP) */
+void lindley_traces(const double* a, size_t as, const double* s, size_t ss, double* d, size_t n, size_t m, int threads);
+
+#endif
@@ -0,0 +1,192 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Output analysis: time averages, batch means and autocorrelation
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "outstat.h"
+
+
+/* --------------------------------------------------------------------------------
+#   time averages
+-------------------------------------------------------------------------------- */
+
+int tavg_init(tavg* ta, int p, double t0, const double* value){
+  ta->p = p;
+  ta->t0 = t0;
+  ta->t = t0;
+  ta->value = (double*)calloc(p, sizeof(double));
+  ta->area = (double*)calloc(p, sizeof(double));
+  if(ta->value == NULL || ta->area == NULL){
+    tavg_free(ta);
+    return 0;
+  }
+  if(value != NULL){
+    memcpy(ta->value, value, sizeof(double) * p);
+  }
+  return 1;
+};
+
+void tavg_free(tavg* ta){
+  free(ta->value);
+  free(ta->area);
+  ta->value = NULL;
+  ta->area = NULL;
+};
+
+void tavg_mean(const tavg* ta, double t, double* out){
+  double dt = t - ta->t;
+  double len = t - ta->t0;
+  for(int i=0; i<ta->p; i++){
+    out[i] = (len > 0.) ? (ta->area[i] + dt * ta->value[i]) / len : NAN;
+  }
+};
+
+
+/* --------------------------------------------------------------------------------
+#   batch means
+-------------------------------------------------------------------------------- */
+
+int bm_init(batch_means* bm, int nb){
+  bm->nb = nb;
+  bm->k = 0;
+  bm->b = 1;
+  bm->in_batch = 0;
+  bm->sum = 0.;
+  bm->mean = (double*)calloc(2 * (size_t)nb, sizeof(double));
+  return bm->mean != NULL;
+};
+
+void bm_free(batch_means* bm){
+  free(bm->mean);
+  bm->mean = NULL;
+};
+
+void bm_update(batch_means* bm, const double x){
+  bm->sum += x;
+  bm->in_batch++;
+  if(bm->in_batch < bm->b){
+    return;
+  }
+
+  bm->mean[bm->k++] = bm->sum / (double)bm->b;
+  bm->sum = 0.;
+  bm->in_batch = 0;
+
+  /* full: average adjacent pairs and double the batch size */
+  if(bm->k == 2 * bm->nb){
+    for(int i=0; i<bm->nb; i++){
+      bm->mean[i] = 0.5 * (bm->mean[2*i] + bm->mean[2*i+1]);
+    }
+    bm->k = bm->nb;
+    bm->b *= 2;
+  }
+};
+
+void bm_summary(const batch_means* bm, welford* w){
+  welford_init(w);
+  for(int i=0; i<bm->k; i++){
+    welford_update(w, bm->mean[i]);
+  }
+};
+
+
+/* --------------------------------------------------------------------------------
+#   autocorrelation
+-------------------------------------------------------------------------------- */
+
+int acs_init(acs* ac, int K){
+  ac->K = K;
+  ac->n = 0;
+  ac->p = 0;
+  ac->sum = 0.;
+  ac->hold = (double*)calloc((size_t)K + 1, sizeof(double));
+  ac->cosum = (double*)calloc((size_t)K + 1, sizeof(double));
+  if(ac->hold == NULL || ac->cosum == NULL){
+    acs_free(ac);
+    return 0;
+  }
+  return 1;
+};
+
+void acs_free(acs* ac){
+  free(ac->hold);
+  free(ac->cosum);
+  ac->hold = NULL;
+  ac->cosum = NULL;
+};
+
+/* the oldest held value times each of the K+1 held values, starting with itself */
+static inline void acs_accumulate(const int K, const int p, const double* hold, double* cosum){
+  for(int j=0; j<=K; j++){
+    int q = p + j;
+    q = (q > K) ? q - (K + 1) : q;
+    cosum[j] += hold[p] * hold[q];
+  }
+};
+
+void acs_update(acs* ac, const double x){
+  const int K = ac->K;
+  if(ac->n < K + 1){
+    /* initialize the hold array */
+    ac->hold[ac->n] = x;
+  } else {
+    acs_accumulate(K, ac->p, ac->hold, ac->cosum);
+    ac->hold[ac->p] = x;
+    ac->p = (ac->p == K) ? 0 : ac->p + 1;
+  }
+  ac->sum += x;
+  ac->n++;
+};
+
+void acs_result(const acs* ac, double* r, double* work){
+  const int K = ac->K;
+  const int64_t n = ac->n;
+
+  /* flush the hold array (in a copy) */
+  double* hold = work;
+  double* cosum = work + (K + 1);
+  memcpy(hold, ac->hold, sizeof(double) * (K + 1));
+  memcpy(cosum, ac->cosum, sizeof(double) * (K + 1));
+
+  int p = ac->p;
+  int64_t held = (n < K + 1) ? n : K + 1;
+  for(int64_t i=0; i<held; i++){
+    acs_accumulate(K, p, hold, cosum);
+    hold[p] = 0.;
+    p = (p == K) ? 0 : p + 1;
+  }
+
+  double mean = ac->sum / (double)n;
+  for(int j=0; j<=K; j++){
+    cosum[j] = (n > j) ? cosum[j] / (double)(n - j) - mean * mean : NAN;
+  }
+  for(int j=0; j<=K; j++){
+    r[j] = cosum[j] / cosum[0];
+  }
+};
+
+
+/* --------------------------------------------------------------------------------
+#   combined output statistics
+-------------------------------------------------------------------------------- */
+
+int outstat_init(outstat* os, int nb, int K){
+  welford_init(&os->all);
+  os->bm.mean = NULL;
+  os->ac.hold = NULL;
+  os->ac.cosum = NULL;
+  if(!bm_init(&os->bm, nb) || !acs_init(&os->ac, K)){
+    outstat_free(os);
+    return 0;
+  }
+  return 1;
+};
+
+void outstat_free(outstat* os){
+  bm_free(&os->bm);
+  acs_free(&os->ac);
+};
@@ -0,0 +1,126 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Output analysis: time averages, batch means and autocorrelation
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef OUTSTAT_H
+#define OUTSTAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "welford.h"
+
+
+/* --------------------------------------------------------------------------------
+#   time-averaged statistics of p piecewise-constant signals (e.g. l(t), q(t), x(t)):
+#   the integral of each signal is accumulated at every change, so no trajectory is stored
+-------------------------------------------------------------------------------- */
+
+typedef struct tavg {
+  int     p;
+  double  t0;      /* start of the observation period */
+  double  t;       /* time of the last change         */
+  double* value;   /* current value of each signal    */
+  double* area;    /* integral of each signal, t0..t  */
+} tavg;
+
+/* return 0 if memory could not be allocated */
+int tavg_init(tavg* ta, int p, double t0, const double* value);
+
+void tavg_free(tavg* ta);
+
+/* advance to time t >= ta->t, then set the signals to value (unchanged if value is NULL) */
+static inline void tavg_update(tavg* ta, const double t, const double* value){
+  double dt = t - ta->t;
+  for(int i=0; i<ta->p; i++){
+    ta->area[i] += dt * ta->value[i];
+  }
+  ta->t = t;
+  if(value != NULL){
+    memcpy(ta->value, value, sizeof(double) * ta->p);
+  }
+};
+
+/* time averages over t0..t for t >= ta->t, i.e. the signals are assumed unchanged since ta->t */
+void tavg_mean(const tavg* ta, double t, double* out);
+
+
+/* --------------------------------------------------------------------------------
+#   batch means with automatic batch size: batches start at size 1, and whenever 2*nb batches are
+#   complete adjacent pairs are averaged and the size doubles, so between nb and 2*nb batches
+#   (of equal size) are always kept in O(nb) memory whatever the run length
+-------------------------------------------------------------------------------- */
+
+typedef struct batch_means {
+  int     nb;       /* minimum number of batches                */
+  int     k;        /* number of complete batches               */
+  int64_t b;        /* batch size                               */
+  int64_t in_batch; /* observations in the current batch        */
+  double  sum;      /* sum of the current batch                 */
+  double* mean;     /* means of the complete batches, 2*nb      */
+} batch_means;
+
+int bm_init(batch_means* bm, int nb);
+
+void bm_free(batch_means* bm);
+
+void bm_update(batch_means* bm, const double x);
+
+/* mean and standard deviation of the complete batch means */
+void bm_summary(const batch_means* bm, welford* w);
+
+
+/* --------------------------------------------------------------------------------
+#   lag-j autocorrelation for j = 0,...,K in one pass (algorithm 4.4.1): the last K+1 observations
+#   are held in a circular buffer and the co-sums are accumulated as they go by
+-------------------------------------------------------------------------------- */
+
+typedef struct acs {
+  int     K;
+  int64_t n;       /* observations so far           */
+  int     p;       /* oldest entry of hold          */
+  double  sum;
+  double* hold;    /* K+1 most recent observations  */
+  double* cosum;   /* K+1 co-sums                   */
+} acs;
+
+int acs_init(acs* ac, int K);
+
+void acs_free(acs* ac);
+
+void acs_update(acs* ac, const double x);
+
+/* r[0,...,K] from the observations so far; the buffer is flushed into a copy in work (2(K+1) doubles,
+   from the caller so that nothing is allocated here), so updates may continue */
+void acs_result(const acs* ac, double* r, double* work);
+
+
+/* --------------------------------------------------------------------------------
+#   all of the above for one output process (e.g. the wait of each job), fed one value at a time
+-------------------------------------------------------------------------------- */
+
+typedef struct outstat {
+  welford     all;   /* mean and standard deviation of every observation */
+  batch_means bm;
+  acs         ac;
+} outstat;
+
+int outstat_init(outstat* os, int nb, int K);
+
+void outstat_free(outstat* os);
+
+static inline void outstat_update(outstat* os, const double x){
+  welford_update(&os->all, x);
+  bm_update(&os->bm, x);
+  acs_update(&os->ac, x);
+};
+
+#endif
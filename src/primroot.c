@@ -0,0 +1,261 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Primitive roots and full-period multipliers
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "primroot.h"
+
+
+/* --------------------------------------------------------------------------------
+#   modular arithmetic and factoring
+#   (products of two values below 2^31 fit in a 64-bit integer)
+-------------------------------------------------------------------------------- */
+
+int pr_pow_mod(int a, int64_t k, int m){
+  int64_t base = a % m;
+  int64_t res = 1 % m;
+
+  if(base < 0){
+    base += m;
+  }
+
+  while(k > 0){
+    if(k & 1){
+      res = (res * base) % m;
+    }
+    base = (base * base) % m;
+    k >>= 1;
+  }
+
+  return (int)res;
+};
+
+int pr_is_prime(int n){
+  if(n < 2){
+    return 0;
+  }
+  if(n < 4){
+    return 1;
+  }
+  if(n % 2 == 0 || n % 3 == 0){
+    return 0;
+  }
+  for(int64_t d=5; d*d<=n; d+=6){
+    if(n % d == 0 || n % (d + 2) == 0){
+      return 0;
+    }
+  }
+  return 1;
+};
+
+int pr_factor(int n, int* q){
+  int nq = 0;
+  for(int64_t d=2; d*d<=n; d += (d == 2) ? 1 : 2){
+    if(n % d == 0){
+      q[nq++] = (int)d;
+      while(n % d == 0){
+        n /= d;
+      }
+    }
+  }
+  if(n > 1){
+    q[nq++] = n;
+  }
+  return nq;
+};
+
+int64_t pr_totient(int n, const int* q, int nq){
+  int64_t phi = n;
+  for(int j=0; j<nq; j++){
+    phi = (phi / q[j]) * (q[j] - 1);
+  }
+  return phi;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   full-period multipliers
+-------------------------------------------------------------------------------- */
+
+int pr_is_full_period(int a, int m, const int* q, int nq){
+  if(a <= 0 || a >= m){
+    return 0;
+  }
+  if(m == 2){
+    return a == 1;
+  }
+  for(int j=0; j<nq; j++){
+    if(pr_pow_mod(a, (m - 1) / q[j], m) == 1){
+      return 0;
+    }
+  }
+  return 1;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   64-bit modular arithmetic and factoring
+-------------------------------------------------------------------------------- */
+
+uint64_t pr_pow_mod64(uint64_t a, uint64_t k, uint64_t m){
+  uint64_t base = a % m;
+  uint64_t res = 1 % m;
+
+  while(k > 0){
+    if(k & 1){
+      res = pr_mul_mod64(res, base, m);
+    }
+    base = pr_mul_mod64(base, base, m);
+    k >>= 1;
+  }
+
+  return res;
+};
+
+/* the first 12 primes are enough witnesses for every n < 3.3e24 */
+static const uint64_t pr_small_primes[12] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+int pr_is_prime64(uint64_t n){
+  if(n < 2){
+    return 0;
+  }
+  for(int i=0; i<12; i++){
+    if(n % pr_small_primes[i] == 0){
+      return n == pr_small_primes[i];
+    }
+  }
+
+  /* n - 1 = d 2^s with d odd */
+  uint64_t d = n - 1;
+  int s = 0;
+  while((d & 1) == 0){
+    d >>= 1;
+    s++;
+  }
+
+  for(int i=0; i<12; i++){
+    uint64_t x = pr_pow_mod64(pr_small_primes[i], d, n);
+    if(x == 1 || x == n - 1){
+      continue;
+    }
+    int composite = 1;
+    for(int j=1; j<s && composite; j++){
+      x = pr_mul_mod64(x, x, n);
+      composite = (x != n - 1);
+    }
+    if(composite){
+      return 0;
+    }
+  }
+  return 1;
+};
+
+static uint64_t pr_gcd64(uint64_t a, uint64_t b){
+  while(b > 0){
+    uint64_t r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+};
+
+/* a nontrivial factor of the odd composite n, by Pollard's rho with Brent's cycle detection */
+static uint64_t pr_rho64(uint64_t n){
+  for(uint64_t c=1; ; c++){
+    uint64_t x = 2, y = 2, ys = 2, prod = 1, d = 1;
+    uint64_t r = 1;
+    const uint64_t batch = 128; /* multiply differences together and take one gcd per batch */
+
+    while(d == 1){
+      x = y;
+      for(uint64_t i=0; i<r; i++){
+        y = (pr_mul_mod64(y, y, n) + c) % n;
+      }
+      for(uint64_t k=0; k<r && d == 1; k+=batch){
+        ys = y;
+        for(uint64_t i=0; i<batch && i<r-k; i++){
+          y = (pr_mul_mod64(y, y, n) + c) % n;
+          prod = pr_mul_mod64(prod, (x > y) ? x - y : y - x, n);
+        }
+        d = pr_gcd64(prod, n);
+      }
+      r *= 2;
+    }
+
+    /* the batch overshot: step back through it one gcd at a time */
+    if(d == n){
+      do {
+        ys = (pr_mul_mod64(ys, ys, n) + c) % n;
+        d = pr_gcd64((x > ys) ? x - ys : ys - x, n);
+      } while(d == 1);
+    }
+
+    if(d != n){
+      return d;
+    }
+  }
+};
+
+static void pr_factor64_rec(uint64_t n, uint64_t* q, int* nq){
+  if(n == 1){
+    return;
+  }
+  if(pr_is_prime64(n)){
+    for(int j=0; j<*nq; j++){
+      if(q[j] == n){
+        return;
+      }
+    }
+    q[(*nq)++] = n;
+    return;
+  }
+  uint64_t d = pr_rho64(n);
+  pr_factor64_rec(d, q, nq);
+  pr_factor64_rec(n / d, q, nq);
+};
+
+int pr_factor64(uint64_t n, uint64_t* q){
+  int nq = 0;
+
+  /* small factors first, then rho on what is left */
+  for(uint64_t d=2; d<1000 && d*d<=n; d += (d == 2) ? 1 : 2){
+    if(n % d == 0){
+      q[nq++] = d;
+      while(n % d == 0){
+        n /= d;
+      }
+    }
+  }
+  pr_factor64_rec(n, q, &nq);
+
+  /* increasing order */
+  for(int i=1; i<nq; i++){
+    uint64_t v = q[i];
+    int j = i - 1;
+    while(j >= 0 && q[j] > v){
+      q[j+1] = q[j];
+      j--;
+    }
+    q[j+1] = v;
+  }
+  return nq;
+};
+
+int pr_is_full_period64(uint64_t a, uint64_t m, const uint64_t* q, int nq){
+  if(a == 0 || a >= m){
+    return 0;
+  }
+  if(m == 2){
+    return a == 1;
+  }
+  for(int j=0; j<nq; j++){
+    if(pr_pow_mod64(a, (m - 1) / q[j], m) == 1){
+      return 0;
+    }
+  }
+  return 1;
+};
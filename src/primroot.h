@@ -0,0 +1,98 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Primitive roots and full-period multipliers
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef PRIMROOT_H
+#define PRIMROOT_H
+
+#include <stdint.h>
+
+/* more than enough distinct prime factors for any n < 2^64 */
+#define PR_MAX_FACTORS 16
+
+
+/* --------------------------------------------------------------------------------
+#   ax mod m with m = aq + r, r < q (algorithm 2.2.1); no intermediate value exceeds m in magnitude,
+#   so the 32-bit version works in int and the 64-bit version in int64_t for any m < 2^63; the result
+#   is in 0,...,m-1 (t = 0 only for x = 0)
+-------------------------------------------------------------------------------- */
+
+static inline int pr_schrage(const int x, const int a, const int q, const int r, const int m){
+  int t = a * (x % q) - r * (x / q);
+  return (t >= 0) ? t : t + m;
+};
+
+static inline int64_t pr_schrage64(const int64_t x, const int64_t a, const int64_t q, const int64_t r, const int64_t m){
+  int64_t t = a * (x % q) - r * (x / q);
+  return (t >= 0) ? t : t + m;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   ab mod m for any a, b, m < 2^64: a 128-bit product where the compiler has one, otherwise
+#   double-and-add with no intermediate value above m (so nothing overflows)
+-------------------------------------------------------------------------------- */
+
+static inline uint64_t pr_mul_mod64(uint64_t a, uint64_t b, const uint64_t m){
+#ifdef __SIZEOF_INT128__
+  return (uint64_t)(((unsigned __int128)a * b) % m);
+#else
+  uint64_t res = 0;
+  a %= m;
+  while(b > 0){
+    if(b & 1){
+      res = (res >= m - a) ? res - (m - a) : res + a;
+    }
+    a = (a >= m - a) ? a - (m - a) : a + a;
+    b >>= 1;
+  }
+  return res;
+#endif
+};
+
+
+/* --------------------------------------------------------------------------------
+#   modular arithmetic and factoring for moduli below 2^31
+-------------------------------------------------------------------------------- */
+
+/* a^k mod m via square-and-multiply */
+int pr_pow_mod(int a, int64_t k, int m);
+
+/* 1 if n is prime (trial division) */
+int pr_is_prime(int n);
+
+/* distinct prime factors of n > 1 in increasing order, written to q; returns how many */
+int pr_factor(int n, int* q);
+
+/* Euler's totient of n given its distinct prime factors */
+int64_t pr_totient(int n, const int* q, int nq);
+
+
+/* --------------------------------------------------------------------------------
+#   full-period multipliers (Theorem 2.1.2): a is full-period relative to the prime m iff a is a
+#   primitive root of m, i.e. a^((m-1)/q) != 1 mod m for every prime factor q of m-1
+-------------------------------------------------------------------------------- */
+
+/* 1 if a is a full-period multiplier relative to the prime m; q holds the nq prime factors of m-1 */
+int pr_is_full_period(int a, int m, const int* q, int nq);
+
+
+/* --------------------------------------------------------------------------------
+#   64-bit versions: deterministic Miller-Rabin for primality and Pollard's rho (Brent's variant)
+#   for the factors of m-1 that trial division does not find
+-------------------------------------------------------------------------------- */
+
+uint64_t pr_pow_mod64(uint64_t a, uint64_t k, uint64_t m);
+
+int pr_is_prime64(uint64_t n);
+
+int pr_factor64(uint64_t n, uint64_t* q);
+
+int pr_is_full_period64(uint64_t a, uint64_t m, const uint64_t* q, int nq);
+
+#endif
@@ -0,0 +1,229 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Random number generation routines: buffer-filling engines
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "rng.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RNG_HAVE_X86 1
+#include <immintrin.h>
+#else
+#define RNG_HAVE_X86 0
+#endif
+
+/* 2^52 as a double: OR-ing an integer below 2^52 into its mantissa and subtracting gives the integer exactly */
+#define RNG_MAGIC_D 4503599627370496.0
+#define RNG_MAGIC_I 0x4330000000000000LL
+
+
+/* --------------------------------------------------------------------------------
+#   scalar engines
+-------------------------------------------------------------------------------- */
+
+static void fill_schrage(long* x, double* out, size_t n){
+  long st = *x;
+  for(size_t i=0; i<n; i++){
+    st = rng_next_schrage(st);
+    out[i] = (double) st / RNG_MODULUS;
+  }
+  *x = st;
+};
+
+static void fill_mersenne(long* x, double* out, size_t n){
+  long st = *x;
+  for(size_t i=0; i<n; i++){
+    st = rng_next_mersenne(st);
+    out[i] = (double) st / RNG_MODULUS;
+  }
+  *x = st;
+};
+
+
+#if RNG_HAVE_X86
+
+/* --------------------------------------------------------------------------------
+#   AVX2: 8 interleaved lanes in two 4 x 64-bit registers
+-------------------------------------------------------------------------------- */
+
+__attribute__((target("avx2")))
+static inline __m256i step_avx2(__m256i v, __m256i a, __m256i m, __m256i mm1){
+  __m256i p = _mm256_mul_epu32(v, a);                                    /* < 2^62 */
+  p = _mm256_add_epi64(_mm256_and_si256(p, m), _mm256_srli_epi64(p, 31)); /* < 2^32 */
+  p = _mm256_add_epi64(_mm256_and_si256(p, m), _mm256_srli_epi64(p, 31)); /* <= M + 1 */
+  __m256i ge = _mm256_cmpgt_epi64(p, mm1);
+  return _mm256_sub_epi64(p, _mm256_and_si256(ge, m));
+};
+
+__attribute__((target("avx2")))
+static inline __m256d to_unif_avx2(__m256i v, __m256i magic_i, __m256d magic_d, __m256d md){
+  __m256d d = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(v, magic_i)), magic_d);
+  return _mm256_div_pd(d, md);
+};
+
+__attribute__((target("avx2")))
+static void fill_avx2(long* x, double* out, size_t n){
+  const size_t L = 8;
+  size_t blocks = n / L;
+  if(blocks < 2){
+    fill_mersenne(x, out, n);
+    return;
+  }
+
+  /* lane j starts at x_{j+1} */
+  long long s[8];
+  long st = *x;
+  for(size_t j=0; j<L; j++){
+    st = rng_next_mersenne(st);
+    s[j] = st;
+  }
+
+  const __m256i a = _mm256_set1_epi64x(rng_mult_pow(RNG_MULTIPLIER, L));
+  const __m256i m = _mm256_set1_epi64x(RNG_MODULUS);
+  const __m256i mm1 = _mm256_set1_epi64x(RNG_MODULUS - 1);
+  const __m256i magic_i = _mm256_set1_epi64x(RNG_MAGIC_I);
+  const __m256d magic_d = _mm256_set1_pd(RNG_MAGIC_D);
+  const __m256d md = _mm256_set1_pd((double)RNG_MODULUS);
+
+  __m256i v0 = _mm256_loadu_si256((const __m256i*)s);
+  __m256i v1 = _mm256_loadu_si256((const __m256i*)(s + 4));
+
+  for(size_t b=0; b<blocks; b++){
+    _mm256_storeu_pd(out + b*L, to_unif_avx2(v0, magic_i, magic_d, md));
+    _mm256_storeu_pd(out + b*L + 4, to_unif_avx2(v1, magic_i, magic_d, md));
+    if(b + 1 < blocks){
+      v0 = step_avx2(v0, a, m, mm1);
+      v1 = step_avx2(v1, a, m, mm1);
+    }
+  }
+
+  /* the last lane holds x_{blocks*L}; finish the tail in scalar */
+  _mm256_storeu_si256((__m256i*)(s + 4), v1);
+  *x = (long)s[7];
+  fill_mersenne(x, out + blocks*L, n - blocks*L);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   AVX-512: 16 interleaved lanes in two 8 x 64-bit registers
+-------------------------------------------------------------------------------- */
+
+__attribute__((target("avx512f")))
+static inline __m512i step_avx512(__m512i v, __m512i a, __m512i m){
+  __m512i p = _mm512_mul_epu32(v, a);
+  p = _mm512_add_epi64(_mm512_and_si512(p, m), _mm512_srli_epi64(p, 31));
+  p = _mm512_add_epi64(_mm512_and_si512(p, m), _mm512_srli_epi64(p, 31));
+  __mmask8 ge = _mm512_cmpge_epu64_mask(p, m);
+  return _mm512_mask_sub_epi64(p, ge, p, m);
+};
+
+__attribute__((target("avx512f")))
+static inline __m512d to_unif_avx512(__m512i v, __m512i magic_i, __m512d magic_d, __m512d md){
+  __m512d d = _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(v, magic_i)), magic_d);
+  return _mm512_div_pd(d, md);
+};
+
+__attribute__((target("avx512f")))
+static void fill_avx512(long* x, double* out, size_t n){
+  const size_t L = 16;
+  size_t blocks = n / L;
+  if(blocks < 2){
+    fill_mersenne(x, out, n);
+    return;
+  }
+
+  long long s[16];
+  long st = *x;
+  for(size_t j=0; j<L; j++){
+    st = rng_next_mersenne(st);
+    s[j] = st;
+  }
+
+  const __m512i a = _mm512_set1_epi64(rng_mult_pow(RNG_MULTIPLIER, L));
+  const __m512i m = _mm512_set1_epi64(RNG_MODULUS);
+  const __m512i magic_i = _mm512_set1_epi64(RNG_MAGIC_I);
+  const __m512d magic_d = _mm512_set1_pd(RNG_MAGIC_D);
+  const __m512d md = _mm512_set1_pd((double)RNG_MODULUS);
+
+  __m512i v0 = _mm512_loadu_si512((const void*)s);
+  __m512i v1 = _mm512_loadu_si512((const void*)(s + 8));
+
+  for(size_t b=0; b<blocks; b++){
+    _mm512_storeu_pd(out + b*L, to_unif_avx512(v0, magic_i, magic_d, md));
+    _mm512_storeu_pd(out + b*L + 8, to_unif_avx512(v1, magic_i, magic_d, md));
+    if(b + 1 < blocks){
+      v0 = step_avx512(v0, a, m);
+      v1 = step_avx512(v1, a, m);
+    }
+  }
+
+  _mm512_storeu_si512((void*)(s + 8), v1);
+  *x = (long)s[15];
+  fill_mersenne(x, out + blocks*L, n - blocks*L);
+};
+
+#endif
+
+
+/* --------------------------------------------------------------------------------
+#   engine selection
+-------------------------------------------------------------------------------- */
+
+int rng_engine_available(int engine){
+  switch(engine){
+    case RNG_ENGINE_AUTO:
+    case RNG_ENGINE_SCHRAGE:
+    case RNG_ENGINE_MERSENNE:
+      return 1;
+#if RNG_HAVE_X86
+    case RNG_ENGINE_AVX2:
+      return __builtin_cpu_supports("avx2");
+    case RNG_ENGINE_AVX512:
+      return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+      return 0;
+  }
+};
+
+int rng_engine_best(void){
+  static int best = -1;
+  if(best < 0){
+    if(rng_engine_available(RNG_ENGINE_AVX512)){
+      best = RNG_ENGINE_AVX512;
+    } else if(rng_engine_available(RNG_ENGINE_AVX2)){
+      best = RNG_ENGINE_AVX2;
+    } else {
+      best = RNG_ENGINE_MERSENNE;
+    }
+  }
+  return best;
+};
+
+int rng_fill_engine(int engine, long* x, double* out, size_t n){
+  if(engine == RNG_ENGINE_AUTO || !rng_engine_available(engine)){
+    engine = rng_engine_best();
+  }
+  switch(engine){
+    case RNG_ENGINE_SCHRAGE:
+      fill_schrage(x, out, n);
+      break;
+#if RNG_HAVE_X86
+    case RNG_ENGINE_AVX2:
+      fill_avx2(x, out, n);
+      break;
+    case RNG_ENGINE_AVX512:
+      fill_avx512(x, out, n);
+      break;
+#endif
+    default:
+      engine = RNG_ENGINE_MERSENNE;
+      fill_mersenne(x, out, n);
+      break;
+  }
+  return engine;
+};
@@ -9,8 +9,174 @@
 
 #include "rng.h"
 
-/* initial seed, use 0 < DEFAULT < MODULUS   */
-static long seed = 123456789L; // seed is the state of the generator
+/* process-wide state used by Random() and friends; stream 0 starts at RNG_DEFAULT */
+static rngs global_rngs;
+static int  global_init = 0;
+
+static rngs* get_global_rngs(void){
+  if(!global_init){
+    rngs_init(&global_rngs);
+    global_init = 1;
+  }
+  return &global_rngs;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   modular arithmetic for jump-ahead
+#   (products of two values below 2^31 fit in an unsigned 64-bit integer)
+-------------------------------------------------------------------------------- */
+
+long rng_mult_pow(long a, uint64_t k){
+  const uint64_t M = (uint64_t)RNG_MODULUS;
+  uint64_t base = (uint64_t)a % M;
+  uint64_t res = 1;
+
+  while(k > 0){
+    if(k & 1){
+      res = (res * base) % M;
+    }
+    base = (base * base) % M;
+    k >>= 1;
+  }
+
+  return (long)res;
+};
+
+long rng_skip(long x, uint64_t k){
+  /* the period is M-1 so reduce k first */
+  uint64_t a_k = (uint64_t)rng_mult_pow(RNG_MULTIPLIER, k % (uint64_t)(RNG_MODULUS - 1));
+  return (long)((a_k * (uint64_t)x) % (uint64_t)RNG_MODULUS);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   reentrant multi-stream interface
+-------------------------------------------------------------------------------- */
+
+/* map any long onto a valid state in 1,...,RNG_MODULUS-1 (0 becomes RNG_DEFAULT) */
+static long reduce_seed(long x){
+  x %= RNG_MODULUS;
+  if(x < 0){
+    x += RNG_MODULUS;
+  }
+  if(x == 0){
+    x = RNG_DEFAULT;
+  }
+  return x;
+};
+
+void rngs_init(rngs* r){
+  rngs_plant_seeds(r, RNG_DEFAULT);
+  r->stream = 0;
+};
+
+void rngs_plant_seeds(rngs* r, long x){
+  const long Q = RNG_MODULUS / RNG_A256;
+  const long R = RNG_MODULUS % RNG_A256;
+
+  x = reduce_seed(x);
+
+  r->seed[0] = x;
+  for(int j=1; j<RNG_STREAMS; j++){
+    x = RNG_A256 * (r->seed[j-1] % Q) - R * (r->seed[j-1] / Q);
+    if(x > 0){
+      r->seed[j] = x;
+    } else {
+      r->seed[j] = x + RNG_MODULUS;
+    }
+  }
+};
+
+void rngs_put_seed(rngs* r, long x){
+  r->seed[r->stream] = reduce_seed(x);
+};
+
+long rngs_get_seed(const rngs* r){
+  return r->seed[r->stream];
+};
+
+void rngs_select_stream(rngs* r, int index){
+  r->stream = ((unsigned int)index) % RNG_STREAMS;
+};
+
+void rngs_skip(rngs* r, uint64_t k){
+  r->seed[r->stream] = rng_skip(r->seed[r->stream], k);
+};
+
+double rngs_random(rngs* r){
+  long x = rng_next(r->seed[r->stream]);
+  r->seed[r->stream] = x;
+  return (double) x / RNG_MODULUS;
+};
+
+double rngs_uniform(rngs* r, const double a, const double b){
+  return a + (b - a) * rngs_random(r);
+};
+
+long rngs_equilikely(rngs* r, const long a, const long b){
+  return a + (long)((b - a + 1) * rngs_random(r));
+};
+
+double rngs_exponential(rngs* r, const double mu){
+  return (-mu * log(1. - rngs_random(r)));
+};
+
+long rngs_geometric(rngs* r, const double p){
+  return (long)(log(1. - rngs_random(r)) / log(p));
+};
+
+long rngs_poisson(rngs* r, const double mu){
+  /* inversion: the smallest x with F(x) > u, accumulating the pmf term by term */
+  double u = rngs_random(r);
+  double pmf = exp(-mu);
+  double cdf = pmf;
+  long x = 0;
+  while(u >= cdf && pmf > 0.){
+    x++;
+    pmf *= mu / (double)x;
+    cdf += pmf;
+  }
+  return x;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   bulk variate generation from the current stream
+-------------------------------------------------------------------------------- */
+
+void rngs_fill_random(rngs* r, double* out, size_t n){
+  rng_fill_engine(RNG_ENGINE_AUTO, &r->seed[r->stream], out, n);
+};
+
+void rngs_fill_uniform(rngs* r, const double a, const double b, double* out, size_t n){
+  const double w = b - a;
+  long x = r->seed[r->stream];
+  for(size_t i=0; i<n; i++){
+    x = rng_next(x);
+    out[i] = a + w * ((double) x / RNG_MODULUS);
+  }
+  r->seed[r->stream] = x;
+};
+
+void rngs_fill_equilikely(rngs* r, const long a, const long b, int* out, size_t n){
+  const double w = (double)(b - a + 1);
+  long x = r->seed[r->stream];
+  for(size_t i=0; i<n; i++){
+    x = rng_next(x);
+    out[i] = (int)(a + (long)(w * ((double) x / RNG_MODULUS)));
+  }
+  r->seed[r->stream] = x;
+};
+
+void rngs_fill_exponential(rngs* r, const double mu, double* out, size_t n){
+  long x = r->seed[r->stream];
+  for(size_t i=0; i<n; i++){
+    x = rng_next(x);
+    out[i] = -mu * log(1. - ((double) x / RNG_MODULUS));
+  }
+  r->seed[r->stream] = x;
+};
 
 
 /* --------------------------------------------------------------------------------
@@ -18,19 +184,48 @@ static long seed = 123456789L; // seed is the state of the generator
 -------------------------------------------------------------------------------- */
 
 double Random(void){
-  const long A = 48271;
-  const long M = 2147483647;
-  const long Q = M / A;
-  const long R = M % A;
+  return rngs_random(get_global_rngs());
+};
+
+
+/* --------------------------------------------------------------------------------
+#   library rngs: global stream management
+-------------------------------------------------------------------------------- */
 
-  long t = A * (seed % Q) - R * (seed / Q);
-  if(t > 0){
-    seed = t;
-  } else {
-    seed = t + M;
+void PlantSeeds(long x){
+  rngs_plant_seeds(get_global_rngs(), x);
+};
+
+void GetSeed(long* x){
+  *x = rngs_get_seed(get_global_rngs());
+};
+
+void PutSeed(long x){
+  rngs_put_seed(get_global_rngs(), x);
+};
+
+void SelectStream(int index){
+  rngs_select_stream(get_global_rngs(), index);
+};
+
+/* check the implementation against the known state after 10000 draws and the first jump; returns 1 if correct */
+int TestRandom(void){
+  rngs r;
+  rngs_plant_seeds(&r, 1);
+  r.stream = 0;
+
+  for(int i=0; i<10000; i++){
+    rngs_random(&r);
   }
+  int ok = (rngs_get_seed(&r) == RNG_CHECK);
+
+  /* stream 1 of PlantSeeds(1) should be A256, and jumping stream 0 should agree */
+  rngs_plant_seeds(&r, 1);
+  rngs_select_stream(&r, 1);
+  ok = ok && (rngs_get_seed(&r) == RNG_A256);
+  ok = ok && (rng_skip(1, RNG_JUMP) == RNG_A256);
 
-  return (double) seed / M;
+  return ok;
 };
 
 
@@ -39,7 +234,7 @@ double Random(void){
 -------------------------------------------------------------------------------- */
 
 double Uniform(const double a, const double b){
-  return a + (b - a) * Random();
+  return rngs_uniform(get_global_rngs(), a, b);
 };
 
 
@@ -48,7 +243,7 @@ double Uniform(const double a, const double b){
 -------------------------------------------------------------------------------- */
 
 long Equilikely(const long a, const long b){
-  return a + (long)((b - a) * Random());
+  return rngs_equilikely(get_global_rngs(), a, b);
 };
 
 
@@ -57,5 +252,5 @@ long Equilikely(const long a, const long b){
 -------------------------------------------------------------------------------- */
 
 double Exponential(const double mu){
-  return (-mu * log(1. - Random()));
+  return rngs_exponential(get_global_rngs(), mu);
 };
@@ -11,9 +11,151 @@
 #define RNG_H
 
 #include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* --------------------------------------------------------------------------------
+#   constants for the multi-stream Lehmer generator (library rngs)
+-------------------------------------------------------------------------------- */
+
+#define RNG_MODULUS    2147483647L /* DON'T CHANGE THIS VALUE                     */
+#define RNG_MULTIPLIER 48271L      /* DON'T CHANGE THIS VALUE                     */
+#define RNG_CHECK      399268537L  /* state of stream 0 after 10000 draws from 1  */
+#define RNG_STREAMS    256         /* # of streams, DON'T CHANGE THIS VALUE       */
+#define RNG_A256       22925L      /* jump multiplier, A^RNG_JUMP mod M           */
+#define RNG_JUMP       8367782L    /* # of states between adjacent streams        */
+#define RNG_DEFAULT    123456789L  /* initial seed, use 0 < DEFAULT < MODULUS     */
+
+
+/* --------------------------------------------------------------------------------
+#   state of the multi-stream generator; one seed per stream
+-------------------------------------------------------------------------------- */
+
+typedef struct rngs {
+  long seed[RNG_STREAMS]; /* current state of each stream */
+  int  stream;            /* stream index, 0 is default   */
+} rngs;
+
+
+/* --------------------------------------------------------------------------------
+#   one step of the Lehmer generator, x -> A*x mod M
+-------------------------------------------------------------------------------- */
+
+/* Schrage's decomposition (algorithm 2.2.1), no intermediate value exceeds M in magnitude */
+static inline long rng_next_schrage(const long x){
+  const long Q = RNG_MODULUS / RNG_MULTIPLIER;
+  const long R = RNG_MODULUS % RNG_MULTIPLIER;
+  long t = RNG_MULTIPLIER * (x % Q) - R * (x / Q);
+  return (t > 0) ? t : t + RNG_MODULUS;
+};
+
+/* 64-bit product folded with 2^31 = 1 mod M (M is a Mersenne prime); no divisions, same result as Schrage */
+static inline long rng_next_mersenne(const long x){
+  uint64_t p = (uint64_t)RNG_MULTIPLIER * (uint64_t)x;   /* < 2^47 */
+  p = (p & (uint64_t)RNG_MODULUS) + (p >> 31);           /* < 2^31 + 2^16 */
+  return (long)((p >= (uint64_t)RNG_MODULUS) ? p - (uint64_t)RNG_MODULUS : p);
+};
+
+static inline long rng_next(const long x){
+  return rng_next_mersenne(x);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   engines for filling a buffer from a single stream (rng-simd.c)
+#   every engine produces the same sequence; the SIMD engines advance interleaved
+#   lanes x_{i}, x_{i+1}, ..., x_{i+L-1} by the jump multiplier A^L mod M
+-------------------------------------------------------------------------------- */
+
+#define RNG_ENGINE_AUTO     0
+#define RNG_ENGINE_SCHRAGE  1
+#define RNG_ENGINE_MERSENNE 2
+#define RNG_ENGINE_AVX2     3
+#define RNG_ENGINE_AVX512   4
+
+/* 1 if the engine can run on this build/CPU */
+int rng_engine_available(int engine);
+
+/* fastest available engine */
+int rng_engine_best(void);
+
+/* fill out[0,...,n-1] with uniform(0,1) variates starting after state *x, and update *x; returns the engine used */
+int rng_fill_engine(int engine, long* x, double* out, size_t n);
+
+
+/* --------------------------------------------------------------------------------
+#   reentrant interface (state passed explicitly)
+-------------------------------------------------------------------------------- */
+
+/* initialize all streams from the default seed and select stream 0 */
+void rngs_init(rngs* r);
+
+/* set the state of all streams, spaced RNG_JUMP states apart, starting from x */
+void rngs_plant_seeds(rngs* r, long x);
+
+/* set the state of the current stream */
+void rngs_put_seed(rngs* r, long x);
+
+/* get the state of the current stream */
+long rngs_get_seed(const rngs* r);
+
+/* select the current stream */
+void rngs_select_stream(rngs* r, int index);
+
+/* advance the current stream by k states in O(log k) */
+void rngs_skip(rngs* r, uint64_t k);
+
+/* produce a uniform(0,1) variate from the current stream */
+double rngs_random(rngs* r);
+
+/* produce Unif(a,b), inclusive integer Unif(a,b) and exponential (mean mu) variates from the current stream */
+double rngs_uniform(rngs* r, const double a, const double b);
+
+long   rngs_equilikely(rngs* r, const long a, const long b);
+
+double rngs_exponential(rngs* r, const double mu);
+
+/* Geometric(p) (number of failures before a success, mean p/(1-p)) and Poisson(mu) variates; each uses exactly
+   one uniform, Poisson by inversion (O(mu) time, mu up to RNG_POISSON_MAX so exp(-mu) does not underflow) */
+#define RNG_POISSON_MAX 700.
+
+long   rngs_geometric(rngs* r, const double p);
+
+long   rngs_poisson(rngs* r, const double mu);
+
+/* fill out[0,...,n-1] with variates from the current stream (no allocation, state kept in a register) */
+void rngs_fill_random(rngs* r, double* out, size_t n);
+
+void rngs_fill_uniform(rngs* r, const double a, const double b, double* out, size_t n);
+
+void rngs_fill_equilikely(rngs* r, const long a, const long b, int* out, size_t n);
+
+void rngs_fill_exponential(rngs* r, const double mu, double* out, size_t n);
+
+/* a^k mod RNG_MODULUS via square-and-multiply */
+long rng_mult_pow(long a, uint64_t k);
+
+/* state k steps after x, i.e. (RNG_MULTIPLIER^k * x) mod RNG_MODULUS */
+long rng_skip(long x, uint64_t k);
+
+
+/* --------------------------------------------------------------------------------
+#   global interface (a single process-wide rngs state)
+-------------------------------------------------------------------------------- */
 
 double Random(void);
 
+void   PlantSeeds(long x);
+
+void   GetSeed(long* x);
+
+void   PutSeed(long x);
+
+void   SelectStream(int index);
+
+int    TestRandom(void);
+
 double Uniform(const double a, const double b);
 
 long   Equilikely(const long a, const long b);
@@ -0,0 +1,209 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Kernels for the simple (s,S) inventory system
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "sis.h"
+
+#include <string.h>
+
+
+/* --------------------------------------------------------------------------------
+#   one interval of program sis1 for a policy (s,S) at inventory level *inv: review, order up
+#   to S when below s (no delivery lag), then accumulate the held and short inventory. The
+#   conditions are 0/1 multipliers rather than branches, so a loop over lanes vectorizes; with
+#   no demand the integrals are divided by 1 instead of 0 (both are 0 since the level is >= 0)
+-------------------------------------------------------------------------------- */
+
+static inline void sis_interval(double s, double S, double dem, double* inv, double* setup, double* holding, double* shortage, double* order){
+  double low = (double)(*inv < s);
+  double ord = low * (S - *inv);
+  *setup += low;
+  *order += ord;
+  double x = *inv + ord;
+
+  double big = (double)(x > dem);
+  double two = 2.0 * dem + (double)(dem == 0.);
+  double t = dem - x;
+  *holding += big * (x - 0.5 * dem) + (1. - big) * ((x * x) / two);
+  *shortage += (1. - big) * ((t * t) / two);
+
+  *inv = x - dem;
+};
+
+/* final time step: match the final inventory, then averages over n intervals */
+static void sis_average(double S, double inv, double setup, double holding, double shortage, double order, double demand, double n, double* out){
+  double last = (inv < S) ? S - inv : 0.;
+  out[0] = (setup + ((last > 0.) ? 1. : 0.)) / n;
+  out[1] = holding / n;
+  out[2] = shortage / n;
+  out[3] = (order + last) / n;
+  out[4] = demand / n;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   many policies, one demand sequence
+-------------------------------------------------------------------------------- */
+
+void sis_lanes_init(sis_lanes* L, const double* s, const double* S){
+  memset(L, 0, sizeof(sis_lanes));
+  for(int l=0; l<SIS_LANES; l++){
+    L->s[l] = s[l];
+    L->S[l] = S[l];
+    L->inv[l] = S[l];
+  }
+};
+
+void sis_lanes_run(sis_lanes* L, const int* d, size_t n){
+
+  /* accumulators in locals so they stay in registers across the interval loop */
+  double inv[SIS_LANES], setup[SIS_LANES], holding[SIS_LANES], shortage[SIS_LANES], order[SIS_LANES];
+  memcpy(inv, L->inv, sizeof(inv));
+  memcpy(setup, L->setup, sizeof(setup));
+  memcpy(holding, L->holding, sizeof(holding));
+  memcpy(shortage, L->shortage, sizeof(shortage));
+  memcpy(order, L->order, sizeof(order));
+  double demand = 0.;
+
+  for(size_t i=0; i<n; i++){
+    double dem = (double)d[i];
+    demand += dem;
+    for(int l=0; l<SIS_LANES; l++){
+      sis_interval(L->s[l], L->S[l], dem, &inv[l], &setup[l], &holding[l], &shortage[l], &order[l]);
+    }
+  }
+
+  memcpy(L->inv, inv, sizeof(inv));
+  memcpy(L->setup, setup, sizeof(setup));
+  memcpy(L->holding, holding, sizeof(holding));
+  memcpy(L->shortage, shortage, sizeof(shortage));
+  memcpy(L->order, order, sizeof(order));
+  L->demand += demand;
+  L->n += (int64_t)n;
+};
+
+void sis_lanes_finish(const sis_lanes* L, double* out){
+  for(int l=0; l<SIS_LANES; l++){
+    sis_average(L->S[l], L->inv[l], L->setup[l], L->holding[l], L->shortage[l], L->order[l], L->demand, (double)L->n, out + SIS_KERNEL_NSTAT * l);
+  }
+};
+
+
+/* --------------------------------------------------------------------------------
+#   one policy, one trace
+-------------------------------------------------------------------------------- */
+
+/* the level and the order and demand totals are integers: only the level is carried from one
+   interval to the next, as an integer add and a select, and the totals are exact */
+typedef struct sis_state {
+  int64_t s, S, inv, setup, order, demand;
+  double holding, shortage;
+} sis_state;
+
+/* rows intervals; called with rows = SIS_TILE for full tiles so the loops have a known trip count */
+static inline void sis_trace_tile(sis_state* st, const int* d, size_t rows){
+  double x[SIS_TILE], h[SIS_TILE], sh[SIS_TILE];
+  int64_t inv = st->inv;
+
+  /* levels after review */
+  for(size_t i=0; i<rows; i++){
+    int64_t low = (inv < st->s);
+    st->setup += low;
+    st->order += low * (st->S - inv);
+    inv = low ? st->S : inv;
+    x[i] = (double)inv;
+    st->demand += d[i];
+    inv -= d[i];
+  }
+  st->inv = inv;
+
+  /* held and short inventory of each interval, independent of each other */
+#ifdef _OPENMP
+  #pragma omp simd
+#endif
+  for(size_t i=0; i<rows; i++){
+    double dem = (double)d[i];
+    double big = (double)(x[i] > dem);
+    double two = 2.0 * dem + (double)(dem == 0.);
+    double t = dem - x[i];
+    h[i] = big * (x[i] - 0.5 * dem) + (1. - big) * ((x[i] * x[i]) / two);
+    sh[i] = (1. - big) * ((t * t) / two);
+  }
+
+  /* summed in interval order, as program sis1 does */
+  for(size_t i=0; i<rows; i++){
+    st->holding += h[i];
+    st->shortage += sh[i];
+  }
+};
+
+void sis_trace(double s, double S, const int* d, size_t n, double* out){
+  sis_state st = {(int64_t)s, (int64_t)S, (int64_t)S, 0, 0, 0, 0., 0.};
+  size_t full = n - n % SIS_TILE;
+  for(size_t i0=0; i0<full; i0+=SIS_TILE){
+    sis_trace_tile(&st, d + i0, SIS_TILE);
+  }
+  sis_trace_tile(&st, d + full, n - full);
+  sis_average(S, (double)st.inv, (double)st.setup, st.holding, st.shortage, (double)st.order, (double)st.demand, (double)n, out);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   SIS_LANES traces at once: each tile of rows is transposed so the lanes of a row are
+#   contiguous, then every lane advances with the same vector instructions
+-------------------------------------------------------------------------------- */
+
+static void sis_trace_lanes(const int* d, size_t n, const double* s, const double* S, double* out){
+
+  double inv[SIS_LANES], setup[SIS_LANES] = {0.}, holding[SIS_LANES] = {0.}, shortage[SIS_LANES] = {0.};
+  double order[SIS_LANES] = {0.}, demand[SIS_LANES] = {0.};
+  double td[SIS_TILE][SIS_LANES];
+  for(int l=0; l<SIS_LANES; l++){
+    inv[l] = S[l];
+  }
+
+  for(size_t i0=0; i0<n; i0+=SIS_TILE){
+    size_t rows = (n - i0 < SIS_TILE) ? n - i0 : SIS_TILE;
+
+    for(int l=0; l<SIS_LANES; l++){
+      const int* dl = d + i0 + n * l;
+      for(size_t i=0; i<rows; i++){
+        td[i][l] = (double)dl[i];
+      }
+    }
+
+    for(size_t i=0; i<rows; i++){
+      for(int l=0; l<SIS_LANES; l++){
+        demand[l] += td[i][l];
+        sis_interval(s[l], S[l], td[i][l], &inv[l], &setup[l], &holding[l], &shortage[l], &order[l]);
+      }
+    }
+  }
+
+  for(int l=0; l<SIS_LANES; l++){
+    sis_average(S[l], inv[l], setup[l], holding[l], shortage[l], order[l], demand[l], (double)n, out + SIS_KERNEL_NSTAT * l);
+  }
+};
+
+void sis_traces(const int* d, size_t n, size_t m, const double* s, const double* S, double* out, int threads){
+
+  /* full blocks of lanes, then the remaining traces one at a time */
+  long blocks = (long)(m / SIS_LANES);
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(threads) schedule(static)
+#endif
+  for(long b=0; b<blocks; b++){
+    size_t j = (size_t)b * SIS_LANES;
+    sis_trace_lanes(d + n * j, n, s + j, S + j, out + SIS_KERNEL_NSTAT * j);
+  }
+
+  for(size_t j=(size_t)blocks * SIS_LANES; j<m; j++){
+    sis_trace(s[j], S[j], d + n * j, n, out + SIS_KERNEL_NSTAT * j);
+  }
+};
@@ -0,0 +1,64 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Kernels for the simple (s,S) inventory system
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef SIS_H
+#define SIS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* --------------------------------------------------------------------------------
+#   SIS_LANES (s,S) policies advanced together over one demand sequence (common random numbers):
+#   the review, order and holding/shortage integrals of program sis1 are computed for every lane
+#   with selects instead of branches, so the loop over lanes runs in SIMD registers
+-------------------------------------------------------------------------------- */
+
+#define SIS_LANES 8
+
+/* statistics, in the order of the sis programs */
+#define SIS_KERNEL_NSTAT 5
+
+typedef struct sis_lanes {
+  double s[SIS_LANES];        /* policy of each lane                   */
+  double S[SIS_LANES];
+  double inv[SIS_LANES];      /* current inventory level               */
+  double setup[SIS_LANES];    /* sum of setups                         */
+  double holding[SIS_LANES];  /* sum of inventory held (+)             */
+  double shortage[SIS_LANES]; /* sum of inventory short (-)            */
+  double order[SIS_LANES];    /* sum of orders                         */
+  double demand;              /* sum of demands (shared by all lanes)  */
+  int64_t n;                  /* number of intervals                   */
+} sis_lanes;
+
+/* lanes start at their S with no history; unused lanes can be given any s < S */
+void sis_lanes_init(sis_lanes* L, const double* s, const double* S);
+
+/* the next n intervals, with demand d[0,...,n-1] */
+void sis_lanes_run(sis_lanes* L, const int* d, size_t n);
+
+/* final order to S and per-interval averages, out[k + SIS_KERNEL_NSTAT * l] for lane l */
+void sis_lanes_finish(const sis_lanes* L, double* out);
+
+
+/* --------------------------------------------------------------------------------
+#   one policy per demand trace (program sis1); all kernels give bitwise the same averages
+-------------------------------------------------------------------------------- */
+
+/* rows of each trace transposed into lane order at a time by sis_traces */
+#define SIS_TILE 64
+
+/* one trace: the SIS_KERNEL_NSTAT averages of policy (s,S) over demands d[0,...,n-1] */
+void sis_trace(double s, double S, const int* d, size_t n, double* out);
+
+/* m traces: trace j has demands d[i + n*j] and policy (s[j], S[j]), and its averages go to
+   out[k + SIS_KERNEL_NSTAT * j]; blocks of SIS_LANES traces are split across threads (if built with OpenMP) */
+void sis_traces(const int* d, size_t n, size_t m, const double* s, const double* S, double* out, int threads);
+
+#endif
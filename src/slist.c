@@ -18,6 +18,38 @@ void init_int_slist(int_slist* list){
   list->size = 0;
   list->head = NULL;
   list->tail = NULL;
+  list->chunks = NULL;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   get a node from the arena, adding a chunk twice the size of the last if full (NULL if out of memory)
+-------------------------------------------------------------------------------- */
+
+#define INT_CHUNK_MIN 64
+#define INT_CHUNK_MAX (1 << 20)
+
+static int_node* alloc_int_node(int_slist* list){
+
+  int_chunk* chunk = list->chunks;
+
+  if(chunk == NULL || chunk->used == chunk->capacity){
+    int capacity = INT_CHUNK_MIN;
+    if(chunk != NULL){
+      capacity = (chunk->capacity < INT_CHUNK_MAX) ? 2 * chunk->capacity : INT_CHUNK_MAX;
+    }
+    int_chunk* fresh = (int_chunk*)malloc(sizeof(int_chunk) + (size_t)capacity * sizeof(int_node));
+    if(fresh == NULL){
+      return NULL;
+    }
+    fresh->next = chunk;
+    fresh->used = 0;
+    fresh->capacity = capacity;
+    list->chunks = fresh;
+    chunk = fresh;
+  }
+
+  return &chunk->node[chunk->used++];
 };
 
 
@@ -25,10 +57,13 @@ void init_int_slist(int_slist* list){
 #   append data to the list
 -------------------------------------------------------------------------------- */
 
-void add_int_slist(int_slist* list, int val){
+int add_int_slist(int_slist* list, int val){
 
   /* the new data node */
-  int_node* node = (int_node*)malloc(sizeof(int_node));
+  int_node* node = alloc_int_node(list);
+  if(node == NULL){
+    return 0;
+  }
   node->value = val;
   node->next = NULL;
 
@@ -45,6 +80,7 @@ void add_int_slist(int_slist* list, int val){
 
   /* increment size */
   list->size++;
+  return 1;
 };
 
 /* --------------------------------------------------------------------------------
@@ -53,11 +89,16 @@ void add_int_slist(int_slist* list, int val){
 
 void free_int_slist(int_slist* list){
 
-  int_node* current;
+  int_chunk* current;
 
-  while(list->head != NULL){
-     current = list->head;
-     list->head = list->head->next;
+  /* nodes live in the chunks, so only the chunks need to be freed */
+  while(list->chunks != NULL){
+     current = list->chunks;
+     list->chunks = list->chunks->next;
      free(current);
   }
+
+  list->size = 0;
+  list->head = NULL;
+  list->tail = NULL;
 };
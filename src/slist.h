@@ -22,17 +22,26 @@ typedef struct _int_node {
   struct _int_node* next;
 } int_node ;
 
+/* nodes are carved out of chunks that double in size, so appends never call malloc per node */
+typedef struct _int_chunk {
+  struct _int_chunk* next; /* previously allocated chunk */
+  int       used;
+  int       capacity;
+  int_node  node[];
+} int_chunk ;
+
 typedef struct _int_slist {
-  int       size;
-  int_node* head;
-  int_node* tail;
+  int        size;
+  int_node*  head;
+  int_node*  tail;
+  int_chunk* chunks; /* newest chunk first */
 } int_slist ;
 
 /* initialize the list to point to null */
 void init_int_slist(int_slist* list);
 
-/* append data to the list */
-void add_int_slist(int_slist* list, int val);
+/* append data to the list; returns 1 on success, 0 if out of memory (the list is left as it was) */
+int add_int_slist(int_slist* list, int val);
 
 /* free the list */
 void free_int_slist(int_slist* list);
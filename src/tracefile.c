@@ -0,0 +1,357 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Streaming (arrival, service) traces from files
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+#define TRACE_MMAP 1
+#endif
+
+#include "tracefile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+#ifdef TRACE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+/* --------------------------------------------------------------------------------
+#   binary traces
+-------------------------------------------------------------------------------- */
+
+#define PAIR_BYTES (2 * sizeof(double))
+
+/* fallback: fread into a buffer of chunk pairs */
+static int read_binary_stdio(const char* path, size_t chunk, trace_fn fn, void* ctx, char* msg, size_t len){
+
+  FILE* f = fopen(path, "rb");
+  if(f == NULL){
+    snprintf(msg, len, "cannot open '%s': %s", path, strerror(errno));
+    return 0;
+  }
+  double* buf = (double*)malloc(chunk * PAIR_BYTES);
+  if(buf == NULL){
+    fclose(f);
+    snprintf(msg, len, "unable to allocate memory for %zu pairs", chunk);
+    return 0;
+  }
+
+  int ok = 1;
+  size_t got;
+  while((got = fread(buf, 1, chunk * PAIR_BYTES, f)) > 0){
+    if(got % PAIR_BYTES != 0){
+      snprintf(msg, len, "'%s' does not hold a whole number of (arrival, service) pairs of doubles", path);
+      ok = 0;
+      break;
+    }
+    fn(ctx, buf, got / PAIR_BYTES);
+  }
+  if(ok && ferror(f)){
+    snprintf(msg, len, "error reading '%s'", path);
+    ok = 0;
+  }
+
+  free(buf);
+  fclose(f);
+  return ok;
+};
+
+int trace_read_binary(const char* path, size_t chunk, trace_fn fn, void* ctx, char* msg, size_t len){
+
+#ifdef TRACE_MMAP
+  int fd = open(path, O_RDONLY);
+  if(fd < 0){
+    snprintf(msg, len, "cannot open '%s': %s", path, strerror(errno));
+    return 0;
+  }
+  struct stat sb;
+  if(fstat(fd, &sb) != 0 || !S_ISREG(sb.st_mode)){
+    /* pipes and devices cannot be mapped */
+    close(fd);
+    return read_binary_stdio(path, chunk, fn, ctx, msg, len);
+  }
+  uint64_t size = (uint64_t)sb.st_size;
+  if(size % PAIR_BYTES != 0){
+    close(fd);
+    snprintf(msg, len, "'%s' does not hold a whole number of (arrival, service) pairs of doubles", path);
+    return 0;
+  }
+
+  /* windows of whole pages (which hold whole pairs), mapped and unmapped in turn so only one is resident;
+     sequential access lets the kernel read ahead while the previous window is processed */
+  uint64_t page = (uint64_t)sysconf(_SC_PAGESIZE);
+  uint64_t window = ((uint64_t)chunk * PAIR_BYTES + page - 1) / page * page;
+
+  for(uint64_t off=0; off<size; off+=window){
+    size_t w = (size_t)((size - off < window) ? size - off : window);
+    void* map = mmap(NULL, w, PROT_READ, MAP_PRIVATE, fd, (off_t)off);
+    if(map == MAP_FAILED){
+      if(off == 0){
+        close(fd);
+        return read_binary_stdio(path, chunk, fn, ctx, msg, len);
+      }
+      snprintf(msg, len, "cannot map '%s' at byte %llu: %s", path, (unsigned long long)off, strerror(errno));
+      close(fd);
+      return 0;
+    }
+    posix_madvise(map, w, POSIX_MADV_SEQUENTIAL);
+    fn(ctx, (const double*)map, w / PAIR_BYTES);
+    munmap(map, w);
+  }
+
+  close(fd);
+  return 1;
+#else
+  return read_binary_stdio(path, chunk, fn, ctx, msg, len);
+#endif
+};
+
+
+/* --------------------------------------------------------------------------------
+#   text traces
+-------------------------------------------------------------------------------- */
+
+/* 10^0,...,10^22 are exact doubles */
+static const double pow10_exact[23] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* parse a decimal number at p, set *end past it (to p on failure). Numbers with at most 15 significant
+   digits and a power of ten within 10^22 are computed as one exact integer times or divided by one exact
+   power of ten, which is correctly rounded (Clinger's fast path); everything else goes to strtod, so the
+   result is always the same as strtod's */
+static double parse_double(const char* p, const char** end){
+
+  const char* q = p;
+  int neg = 0;
+  if(*q == '-' || *q == '+'){
+    neg = (*q == '-');
+    q++;
+  }
+
+  uint64_t mant = 0;
+  int digits = 0;   /* significant digits in mant */
+  int exp10 = 0;
+  int any = 0;
+
+  while(*q == '0'){
+    q++;
+    any = 1;
+  }
+  while(*q >= '0' && *q <= '9'){
+    if(digits < 19){
+      mant = 10 * mant + (uint64_t)(*q - '0');
+    } else {
+      exp10++;
+    }
+    digits++;
+    q++;
+    any = 1;
+  }
+  if(*q == '.'){
+    q++;
+    if(digits == 0){
+      while(*q == '0'){
+        exp10--;
+        q++;
+        any = 1;
+      }
+    }
+    while(*q >= '0' && *q <= '9'){
+      if(digits < 19){
+        mant = 10 * mant + (uint64_t)(*q - '0');
+        exp10--;
+      }
+      digits++;
+      q++;
+      any = 1;
+    }
+  }
+  if(any && (*q == 'e' || *q == 'E')){
+    const char* r = q + 1;
+    int eneg = 0;
+    if(*r == '-' || *r == '+'){
+      eneg = (*r == '-');
+      r++;
+    }
+    if(*r >= '0' && *r <= '9'){
+      int e = 0;
+      while(*r >= '0' && *r <= '9'){
+        e = (e < 10000) ? 10 * e + (*r - '0') : e;
+        r++;
+      }
+      exp10 += eneg ? -e : e;
+      q = r;
+    }
+  }
+
+  if(any && digits <= 15 && exp10 >= -22 && exp10 <= 22){
+    double x = (double)mant;
+    x = (exp10 < 0) ? x / pow10_exact[-exp10] : x * pow10_exact[exp10];
+    *end = q;
+    return neg ? -x : x;
+  }
+
+  /* long mantissas, extreme exponents, inf and nan */
+  char* e;
+  double x = strtod(p, &e);
+  *end = e;
+  return x;
+};
+
+static int is_blank(char ch){
+  return ch == ' ' || ch == '\t' || ch == '\r';
+};
+
+/* skip blanks and at most one ',' or ';' among them */
+static void skip_separator(const char** p, const char* eol){
+  int seps = 0;
+  while(*p < eol && (is_blank(**p) || (seps == 0 && (**p == ',' || **p == ';')))){
+    seps += (**p == ',' || **p == ';');
+    (*p)++;
+  }
+};
+
+/* parse one line [p, eol) into a pair; 1 on success */
+static int parse_line(const char* p, const char* eol, double* pair){
+  const char* end;
+  while(p < eol && is_blank(*p)){
+    p++;
+  }
+  pair[0] = parse_double(p, &end);
+  if(end == p || end > eol){
+    return 0;
+  }
+  p = end;
+  skip_separator(&p, eol);
+  if(p == end){
+    return 0;
+  }
+  pair[1] = parse_double(p, &end);
+  if(end == p || end > eol){
+    return 0;
+  }
+  p = end;
+  skip_separator(&p, eol);
+  return p == eol;
+};
+
+/* 1 if the line starting (after blanks) at p cannot start with a number, so it may be a header */
+static int is_header(const char* p){
+  const char* end;
+  parse_double(p, &end);
+  return end == p;
+};
+
+int trace_read_text(const char* path, size_t chunk, trace_fn fn, void* ctx, char* msg, size_t len){
+
+  FILE* f = fopen(path, "rb");
+  if(f == NULL){
+    snprintf(msg, len, "cannot open '%s': %s", path, strerror(errno));
+    return 0;
+  }
+
+  /* room for about chunk lines of text, and the pairs parsed from them */
+  size_t cap = (chunk < 128) ? 4096 : chunk * 32;
+  char* text = (char*)malloc(cap + 1);
+  double* pairs = (double*)malloc(chunk * PAIR_BYTES);
+  if(text == NULL || pairs == NULL){
+    free(text);
+    free(pairs);
+    fclose(f);
+    snprintf(msg, len, "unable to allocate memory for %zu pairs", chunk);
+    return 0;
+  }
+
+  int ok = 1;
+  size_t have = 0;   /* bytes in text, the first of which are an incomplete line carried over */
+  size_t np = 0;     /* pairs parsed but not yet handed on */
+  uint64_t line = 0;
+  int first = 1;     /* the next non-blank, non-comment line is the first, which may be a header */
+  int eof = 0;
+
+  while(ok && !eof){
+
+    size_t got = fread(text + have, 1, cap - have, f);
+    have += got;
+    if(got == 0){
+      if(ferror(f)){
+        snprintf(msg, len, "error reading '%s'", path);
+        ok = 0;
+        break;
+      }
+      eof = 1;
+    }
+    text[have] = '\0';
+
+    /* complete lines; at the end of the file the last line need not end in a newline */
+    char* p = text;
+    char* stop = text + have;
+    while(ok && p < stop){
+      char* eol = memchr(p, '\n', (size_t)(stop - p));
+      if(eol == NULL){
+        if(!eof){
+          break;
+        }
+        eol = stop;
+      }
+      line++;
+
+      const char* q = p;
+      while(q < eol && is_blank(*q)){
+        q++;
+      }
+      if(q < eol && *q != '#'){
+        char save = *eol;
+        *eol = '\0';  /* so strtod cannot run past the line */
+        if(parse_line(p, eol, pairs + 2 * np)){
+          if(++np == chunk){
+            fn(ctx, pairs, np);
+            np = 0;
+          }
+        } else if(!first || !is_header(q)){
+          snprintf(msg, len, "line %llu of '%s' is not an (arrival, service) pair", (unsigned long long)line, path);
+          ok = 0;
+        }
+        first = 0;
+        *eol = save;
+      }
+      p = eol + 1;
+    }
+
+    /* carry the incomplete line to the front of the buffer */
+    if(ok && !eof){
+      size_t rest = (p < stop) ? (size_t)(stop - p) : 0;
+      if(rest == cap){
+        snprintf(msg, len, "line %llu of '%s' is longer than %zu bytes", (unsigned long long)line + 1, path, cap);
+        ok = 0;
+      }
+      memmove(text, p, rest);
+      have = rest;
+    }
+  }
+
+  if(ok && np > 0){
+    fn(ctx, pairs, np);
+  }
+
+  free(text);
+  free(pairs);
+  fclose(f);
+  return ok;
+};
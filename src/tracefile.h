@@ -0,0 +1,37 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Streaming (arrival, service) traces from files
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef TRACEFILE_H
+#define TRACEFILE_H
+
+#include <stddef.h>
+
+
+/* --------------------------------------------------------------------------------
+#   a trace is read in chunks of at most 'chunk' pairs; each chunk is handed to a callback
+#   as pairs[0] = a_0, pairs[1] = s_0, pairs[2] = a_1, ... and is only valid during the call,
+#   so memory use is O(chunk) whatever the size of the file
+-------------------------------------------------------------------------------- */
+
+#define TRACE_BINARY 0 /* pairs of doubles in native byte order, e.g. from R's writeBin        */
+#define TRACE_TEXT   1 /* one pair per line separated by blanks and at most one ',' or ';';    */
+                       /* blank lines and lines starting with '#' are skipped, as is a header  */
+
+/* called with each chunk of n pairs */
+typedef void (*trace_fn)(void* ctx, const double* pairs, size_t n);
+
+/* binary trace, memory mapped one window at a time where the platform allows (zero copy), read
+   with fread otherwise; returns 1 on success, 0 with a message in msg on failure */
+int trace_read_binary(const char* path, size_t chunk, trace_fn fn, void* ctx, char* msg, size_t len);
+
+/* text trace, read in blocks and parsed without copying lines; returns 1 on success, 0 with a
+   message in msg on failure */
+int trace_read_text(const char* path, size_t chunk, trace_fn fn, void* ctx, char* msg, size_t len);
+
+#endif
@@ -0,0 +1,151 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   State transition functions for cycle detection (Ch. 2.5)
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "trans.h"
+
+
+/* --------------------------------------------------------------------------------
+#   element of a named list, or R_NilValue
+-------------------------------------------------------------------------------- */
+
+/* element of a named list, or R_NilValue (also if the list has no names) */
+static SEXP list_elt(SEXP list, const char* name){
+  SEXP nms = Rf_getAttrib(list, R_NamesSymbol);
+  if(!Rf_isString(nms) || XLENGTH(nms) != XLENGTH(list)){
+    return R_NilValue;
+  }
+  for(R_xlen_t i=0; i<XLENGTH(list); i++){
+    if(STRING_ELT(nms, i) != NA_STRING && strcmp(CHAR(STRING_ELT(nms, i)), name) == 0){
+      return VECTOR_ELT(list, i);
+    }
+  }
+  return R_NilValue;
+};
+
+static int list_int(SEXP list, const char* name){
+  SEXP x = list_elt(list, name);
+  if(Rf_isNull(x)){
+    Rf_error("transition descriptor is missing '%s'", name);
+  }
+  return Rf_asInteger(x);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   read a transition function from R
+-------------------------------------------------------------------------------- */
+
+void get_trans(trans* tr, SEXP g, SEXP rho){
+
+  memset(tr, 0, sizeof(trans));
+
+  /* an R closure: build the call g(x) once and reuse it */
+  if(Rf_isFunction(g)){
+    if(!Rf_isEnvironment(rho)){
+      Rf_error("'rho' should be an environment");
+    }
+    tr->type = TRANS_R;
+    SEXP xarg = PROTECT(Rf_allocVector(INTSXP, 1));
+    tr->call = PROTECT(Rf_lang2(g, xarg));
+    tr->arg = INTEGER(xarg);
+    tr->rho = rho;
+    tr->nprotect = 2;
+    return;
+  }
+
+  if(TYPEOF(g) != VECSXP || !Rf_inherits(g, "des_trans")){
+    Rf_error("'g' should be a function or a transition made by 'lehmer_trans', 'lcg_trans' or 'native_trans'");
+  }
+
+  SEXP typeR = list_elt(g, "type");
+  if(!Rf_isString(typeR) || XLENGTH(typeR) != 1 || STRING_ELT(typeR, 0) == NA_STRING){
+    Rf_error("transition descriptor should give 'type' as a single string");
+  }
+  const char* type = CHAR(STRING_ELT(typeR, 0));
+
+  if(strcmp(type, "lehmer") == 0 || strcmp(type, "lcg") == 0){
+    tr->type = (strcmp(type, "lehmer") == 0) ? TRANS_LEHMER : TRANS_LCG;
+    tr->a = list_int(g, "a");
+    tr->m = list_int(g, "m");
+    tr->c = (tr->type == TRANS_LCG) ? list_int(g, "c") : 0;
+    if(tr->m == NA_INTEGER || tr->m < 2 || tr->a == NA_INTEGER || tr->a < 1 || tr->a >= tr->m || tr->c == NA_INTEGER || tr->c < 0 || tr->c >= tr->m){
+      Rf_error("transition should have m > 1, 0 < a < m and 0 <= c < m");
+    }
+    tr->compat = (tr->m % tr->a) < (tr->m / tr->a);
+  } else if(strcmp(type, "native") == 0){
+    tr->type = TRANS_NATIVE;
+    SEXP pkg = list_elt(g, "package");
+    SEXP name = list_elt(g, "name");
+    if(!Rf_isString(pkg) || !Rf_isString(name) || XLENGTH(pkg) != 1 || XLENGTH(name) != 1){
+      Rf_error("native transition should give 'package' and 'name' as single strings");
+    }
+    /* R_GetCCallable errors if the function was not registered */
+    tr->fn = (trans_fn)R_GetCCallable(CHAR(STRING_ELT(pkg, 0)), CHAR(STRING_ELT(name, 0)));
+  } else {
+    Rf_error("unknown transition type '%s'", type);
+  }
+};
+
+
+int get_trans_x0(const trans* tr, SEXP x0R){
+  int x0 = Rf_asInteger(x0R);
+  if(x0 == NA_INTEGER){
+    Rf_error("'x0' should be an integer");
+  }
+  if(tr->type == TRANS_LEHMER && (x0 < 1 || x0 >= tr->m)){
+    Rf_error("'x0' should be in 1,...,m-1 for a Lehmer transition");
+  }
+  if(tr->type == TRANS_LCG && (x0 < 0 || x0 >= tr->m)){
+    Rf_error("'x0' should be in 0,...,m-1 for a linear congruential transition");
+  }
+  return x0;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   jump ahead: the k-fold composition of x -> (ax + c) mod m is x -> (Ax + C) mod m,
+#   computed by square-and-multiply on the pair (A, C)
+-------------------------------------------------------------------------------- */
+
+int trans_jump(const trans* tr, int x, uint64_t k){
+
+  const uint64_t m = (uint64_t)tr->m;
+
+  uint64_t a = (uint64_t)tr->a;  /* current power of the map: x -> ax + c */
+  uint64_t c = (uint64_t)tr->c;
+  uint64_t A = 1;                /* accumulated map: x -> Ax + C */
+  uint64_t C = 0;
+
+  while(k > 0){
+    if(k & 1){
+      /* apply (a, c) after (A, C) */
+      A = (a * A) % m;
+      C = (a * C + c) % m;
+    }
+    /* (a, c) composed with itself */
+    c = (a * c + c) % m;
+    a = (a * a) % m;
+    k >>= 1;
+  }
+
+  return (int)((A * (uint64_t)x + C) % m);
+};
+
+
+/* --------------------------------------------------------------------------------
+#   interrupts during walks of a native g
+-------------------------------------------------------------------------------- */
+
+static void trans_check_interrupt(void* unused){
+  R_CheckUserInterrupt();
+};
+
+int trans_interrupted(void){
+  return R_ToplevelExec(trans_check_interrupt, NULL) == FALSE;
+};
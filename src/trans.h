@@ -0,0 +1,101 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   State transition functions for cycle detection (Ch. 2.5)
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef TRANS_H
+#define TRANS_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <R.h>
+#include <Rinternals.h>
+#include <R_ext/Rdynload.h> // for R_GetCCallable
+
+
+/* --------------------------------------------------------------------------------
+#   a state transition function g(x), either an R closure or a native descriptor
+-------------------------------------------------------------------------------- */
+
+#define TRANS_R      0 /* R function, evaluated with Rf_eval                       */
+#define TRANS_LEHMER 1 /* g(x) = ax mod m                                          */
+#define TRANS_LCG    2 /* g(x) = (ax + c) mod m                                    */
+#define TRANS_NATIVE 3 /* int g(int x) registered by a package via R_RegisterCCallable */
+
+/* signature of native transition functions */
+typedef int (*trans_fn)(int x);
+
+typedef struct trans {
+  int      type;
+  int      a;         /* multiplier                                 */
+  int      c;         /* increment (TRANS_LCG)                      */
+  int      m;         /* modulus                                    */
+  int      compat;    /* 1 if a is modulus-compatible (use 2.2.1)   */
+  trans_fn fn;        /* TRANS_NATIVE                               */
+  SEXP     call;      /* TRANS_R: the call g(x) ...                 */
+  int*     arg;       /*   ... a pointer into its argument x        */
+  SEXP     rho;       /*   ... and the environment to evaluate it in */
+  int      nprotect;  /* number of objects PROTECTed by get_trans   */
+} trans;
+
+/* read g (an R function or a 'des_trans' descriptor); the caller must UNPROTECT(tr->nprotect) when done */
+void get_trans(trans* tr, SEXP g, SEXP rho);
+
+/* read the initial state for g: not NA, in 1,...,m-1 for a Lehmer transition (0 is a fixed point) and in
+   0,...,m-1 for an LCG */
+int get_trans_x0(const trans* tr, SEXP x0R);
+
+/* internal C version of 2.2.1 (des-2.c) */
+int g(const int x, const int a, const int m);
+
+/* evaluate x_{t+1} = g(x_{t}) */
+static inline int trans_eval(const trans* tr, const int x){
+  switch(tr->type){
+    case TRANS_LEHMER:
+      return tr->compat ? g(x, tr->a, tr->m) : (int)(((int64_t)tr->a * x) % tr->m);
+    case TRANS_LCG:
+      return (int)(((int64_t)tr->a * x + tr->c) % tr->m);
+    case TRANS_NATIVE:
+      return tr->fn(x);
+    default:
+      tr->arg[0] = x;
+      return Rf_asInteger(Rf_eval(tr->call, tr->rho));
+  }
+};
+
+/* 1 if x_{t+k} can be computed from x_{t} in O(log k) (Lehmer and LCG transitions) */
+static inline int trans_can_jump(const trans* tr){
+  return tr->type == TRANS_LEHMER || tr->type == TRANS_LCG;
+};
+
+/* x_{t+k} from x_{t}, for transitions where trans_can_jump is 1 */
+int trans_jump(const trans* tr, int x, uint64_t k);
+
+/* 1 if g can be evaluated without touching the R API (and hence from any thread) */
+static inline int trans_is_native(const trans* tr){
+  return tr->type != TRANS_R;
+};
+
+/* a native g never returns to R, where interrupts are noticed, so long walks poll every TRANS_POLL evaluations */
+#define TRANS_POLL ((int64_t)1 << 20)
+
+/* count n more evaluations of g; 1 if a native g has been evaluated TRANS_POLL times since the last poll */
+static inline int trans_poll_due(const trans* tr, int64_t* count, int64_t n){
+  *count += n;
+  if(*count < TRANS_POLL || !trans_is_native(tr)){
+    return 0;
+  }
+  *count = 0;
+  return 1;
+};
+
+/* 1 if the user has interrupted; unlike R_CheckUserInterrupt it returns, so the caller can free memory first */
+int trans_interrupted(void);
+
+#endif
@@ -0,0 +1,130 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Mergeable accumulators for Welford's one pass algorithm
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#include "welford.h"
+
+#include <stdlib.h>
+
+
+void welford_init(welford* w){
+  w->n = 0;
+  w->xbar = 0.;
+  w->v = 0.;
+  w->min = INFINITY;
+  w->max = -INFINITY;
+};
+
+void welford_merge(welford* a, const welford* b){
+  if(b->n == 0){
+    return;
+  }
+  if(a->n == 0){
+    *a = *b;
+    return;
+  }
+  double na = (double)a->n;
+  double nb = (double)b->n;
+  double n = na + nb;
+  double d = b->xbar - a->xbar;
+
+  a->xbar += d * (nb / n);
+  a->v += b->v + d * d * (na * nb / n);
+  a->n += b->n;
+  a->min = (b->min < a->min) ? b->min : a->min;
+  a->max = (b->max > a->max) ? b->max : a->max;
+};
+
+
+/* --------------------------------------------------------------------------------
+#   block update: lane l takes x[l], x[l+L], x[l+2L], ...; every lane has seen the same number of
+#   observations at each step, so 1/n is shared and the lane updates vectorize
+-------------------------------------------------------------------------------- */
+
+void welford_update_block(welford* w, const double* x, size_t n){
+
+  const size_t L = WELFORD_LANES;
+  size_t rounds = n / L;
+
+  if(rounds > 0){
+    double xbar[WELFORD_LANES] = {0.};
+    double v[WELFORD_LANES] = {0.};
+    double lo[WELFORD_LANES];
+    double hi[WELFORD_LANES];
+    for(size_t l=0; l<L; l++){
+      lo[l] = INFINITY;
+      hi[l] = -INFINITY;
+    }
+
+    for(size_t k=0; k<rounds; k++){
+      const double* xk = x + k * L;
+      const double inv = 1. / (double)(k + 1);
+      const double c = (double)k * inv;   /* (n-1)/n */
+      for(size_t l=0; l<L; l++){
+        double d = xk[l] - xbar[l];
+        v[l] += d * d * c;
+        xbar[l] += d * inv;
+        lo[l] = (xk[l] < lo[l]) ? xk[l] : lo[l];
+        hi[l] = (xk[l] > hi[l]) ? xk[l] : hi[l];
+      }
+    }
+
+    /* combine the lanes pairwise so rounding error grows with log(L) */
+    welford lane[WELFORD_LANES];
+    for(size_t l=0; l<L; l++){
+      lane[l].n = (int64_t)rounds;
+      lane[l].xbar = xbar[l];
+      lane[l].v = v[l];
+      lane[l].min = lo[l];
+      lane[l].max = hi[l];
+    }
+    for(size_t step=1; step<L; step*=2){
+      for(size_t l=0; l+step<L; l+=2*step){
+        welford_merge(&lane[l], &lane[l+step]);
+      }
+    }
+    welford_merge(w, &lane[0]);
+  }
+
+  for(size_t i=rounds*L; i<n; i++){
+    welford_update(w, x[i]);
+  }
+};
+
+int welford_update_parallel(welford* w, const double* x, size_t n, int threads){
+
+  if(threads < 2 || n < (size_t)threads * 4096){
+    welford_update_block(w, x, n);
+    return 1;
+  }
+
+  /* thread j summarises the j-th contiguous chunk; chunks are merged in order */
+  welford* part = (welford*)malloc(sizeof(welford) * threads);
+  if(part == NULL){
+    return 0;
+  }
+  size_t chunk = (n + threads - 1) / threads;
+
+#ifdef _OPENMP
+  #pragma omp parallel for num_threads(threads) schedule(static, 1)
+#endif
+  for(int j=0; j<threads; j++){
+    size_t from = (size_t)j * chunk;
+    size_t to = (from + chunk < n) ? from + chunk : n;
+    welford_init(&part[j]);
+    if(from < to){
+      welford_update_block(&part[j], x + from, to - from);
+    }
+  }
+
+  for(int j=0; j<threads; j++){
+    welford_merge(w, &part[j]);
+  }
+  free(part);
+  return 1;
+};
@@ -0,0 +1,62 @@
+/* --------------------------------------------------------------------------------
+#
+#   Discrete Event Simultion: A First Course
+#   Mergeable accumulators for Welford's one pass algorithm
+#   Sean Wu (slwu89@berkeley.edu)
+#   October 2026
+#
+-------------------------------------------------------------------------------- */
+
+#ifndef WELFORD_H
+#define WELFORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+
+/* --------------------------------------------------------------------------------
+#   accumulator: count, running mean and sum of squared deviations v (algorithm 4.1.1),
+#   plus the extremes; two accumulators combine exactly by Chan et al.'s pairwise update
+-------------------------------------------------------------------------------- */
+
+typedef struct welford {
+  int64_t n;     /* number of observations          */
+  double  xbar;  /* sample mean                     */
+  double  v;     /* sum of squared deviations       */
+  double  min;
+  double  max;
+} welford;
+
+void welford_init(welford* w);
+
+/* one observation (algorithm 4.1.1) */
+static inline void welford_update(welford* w, const double x){
+  w->n++;
+  double d = x - w->xbar;
+  w->v += d * d * ((double)w->n - 1.) / (double)w->n;
+  w->xbar += d / (double)w->n;
+  w->min = (x < w->min) ? x : w->min;
+  w->max = (x > w->max) ? x : w->max;
+};
+
+/* number of independent accumulators used by welford_update_block */
+#define WELFORD_LANES 8
+
+/* add the observations summarised by b to a */
+void welford_merge(welford* a, const welford* b);
+
+/* x[0,...,n-1], using WELFORD_LANES independent accumulators so there is no loop-carried dependency */
+void welford_update_block(welford* w, const double* x, size_t n);
+
+/* x[0,...,n-1] split across threads (if built with OpenMP), each using welford_update_block;
+   for a given number of threads the result does not depend on scheduling; returns 1 on success,
+   0 (leaving w unchanged) if out of memory */
+int welford_update_parallel(welford* w, const double* x, size_t n, int threads);
+
+/* sample standard deviation s = sqrt(v/n), as in the book */
+static inline double welford_sd(const welford* w){
+  return (w->n > 0) ? sqrt(w->v / (double)w->n) : NAN;
+};
+
+#endif